@@ -8,21 +8,28 @@
 
 #include <CTRL.h>
 
+/*
+  All multiplexers use the same channel select pins (s0 - s3), so we create
+  a bus that owns them. The bus selects each channel once, waits for the
+  multiplexers to settle once, and then samples all of them.
+  Provide the channel select pins: s0 - s3.
+*/
+CtrlMuxBus bus(3, 4, 5, 6);
+
 /*
   Now we create 3 multiplexers and provide the following parameters:
   - signal pin (sig)
-  - s0 - s3: the channel select pins
-  Note that all multiplexers use the same channel select pins (s0 - s3).
+  - a reference to the bus (&bus)
 */
 
 // The button mux. Connect 'sig' to a digital pin on your board.
-CtrlMux btnMux(1, 3, 4, 5, 6);
+CtrlMux btnMux(1, &bus);
 
 // The potentiometer mux. Connect 'sig' to an analog pin on your board.
-CtrlMux potMux(A0, 3, 4, 5, 6);
+CtrlMux potMux(A0, &bus);
 
 // The encoder mux. Connect 'sig' to a digital pin on your board.
-CtrlMux encMux(2, 3, 4, 5, 6);
+CtrlMux encMux(2, &bus);
 
 void onPress1() { Serial.println("Button 1 pressed"); }
 void onRelease1() { Serial.println("Button 1 released"); }
@@ -48,13 +55,10 @@ CtrlEnc encoder2(2, 3, onTurnLeft2, onTurnRight2, &encMux);
 
 void setup() {
     Serial.begin(9600);
-    btnMux.setSwitchInterval(2); // In microseconds.
-    potMux.setSwitchInterval(2); // In microseconds.
-    encMux.setSwitchInterval(2); // In microseconds.
+    bus.setSwitchInterval(2); // In microseconds.
 }
 
 void loop() {
-    btnMux.process();
-    potMux.process();
-    encMux.process();
+    // Processes all 3 multiplexers and their objects.
+    bus.process();
 }
\ No newline at end of file
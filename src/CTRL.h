@@ -30,10 +30,17 @@
 
 #include "CtrlBase.h"
 #include "CtrlBtn.h"
+#include "CtrlBtnBank.h"
+#include "CtrlBtnMatrix.h"
+#include "CtrlClock.h"
+#include "CtrlEventQueue.h"
 #include "CtrlEnc.h"
 #include "CtrlPot.h"
 #include "CtrlLed.h"
 #include "CtrlMux.h"
+#include "CtrlMuxBus.h"
+#include "CtrlSource.h"
+#include "CtrlShiftIn.h"
 #include "CtrlGroup.h"
 #include "Groupable.h"
 #include "Muxable.h"
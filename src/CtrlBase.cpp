@@ -25,7 +25,9 @@
  * THE SOFTWARE.
  */
 
+#include <new>
 #include "CtrlBase.h"
+#include "CtrlClock.h"
 
 void CtrlBase::enable()
 {
@@ -47,4 +49,130 @@ bool CtrlBase::isDisabled() const
     return !this->isEnabled();
 }
 
+uint16_t CtrlBase::priorityVersion = 0;
+
+void CtrlBase::setPriority(const Priority priority)
+{
+    if (this->priority == priority) return;
+    this->priority = priority;
+    ++priorityVersion;
+}
+
+CtrlBase::Priority CtrlBase::getPriority() const
+{
+    return this->priority;
+}
+
+void CtrlBase::markActivity(const unsigned long now)
+{
+    this->lastActivity = now;
+}
+
+bool CtrlBase::isIdleFor(const unsigned long now, const unsigned long timeout) const
+{
+    return now - this->lastActivity >= timeout;
+}
+
+void CtrlBase::setEventQueue(CtrlEventQueue* queue, const uint8_t source)
+{
+    this->eventQueue = queue;
+    this->eventSource = source;
+}
+
+bool CtrlBase::queueEvent(const CtrlEvent::Type type, const int32_t value)
+{
+    if (this->eventQueue == nullptr) return false;
+    CtrlEvent event;
+    event.source = this->eventSource;
+    event.type = type;
+    event.value = value;
+    event.time = CtrlClock::now();
+    this->eventQueue->push(event);
+    return true;
+}
+
+bool CtrlBase::deferEvent(const CtrlEvent::Type type, const int32_t value)
+{
+    return CtrlDeferredEvents::defer(this, type, value);
+}
+
+void CtrlBase::fireEvent(CtrlEvent::Type, int32_t)
+{
+}
+
+CtrlBase::~CtrlBase()
+{
+    CtrlDeferredEvents::forget(this);
+}
+
+CtrlDeferredEvents* CtrlDeferredEvents::active = nullptr;
+CtrlDeferredEvents* CtrlDeferredEvents::firing = nullptr;
+
+CtrlDeferredEvents::CtrlDeferredEvents(const uint8_t capacity)
+{
+    this->records = new (std::nothrow) Record[capacity];
+    this->capacity = this->records != nullptr ? capacity : 0;
+}
+
+CtrlDeferredEvents::~CtrlDeferredEvents()
+{
+    if (active == this) active = nullptr;
+    if (firing == this) firing = nullptr;
+    delete[] this->records;
+}
+
+bool CtrlDeferredEvents::defer(CtrlBase* object, const CtrlEvent::Type type, const int32_t value)
+{
+    if (active == nullptr || active->count >= active->capacity) return false;
+    active->records[active->count++] = {object, type, value};
+    return true;
+}
+
+void CtrlDeferredEvents::forget(const CtrlBase* object)
+{
+    CtrlDeferredEvents* const buffers[] = {active, firing};
+    for (CtrlDeferredEvents* events : buffers) {
+        if (events == nullptr) continue;
+        for (uint8_t i = 0; i < events->count; ++i) {
+            if (events->records[i].object == object) events->records[i].object = nullptr;
+        }
+    }
+}
+
+void CtrlDeferredEvents::fire()
+{
+    // Callbacks fire right away again, e.g. from objects processed by a callback.
+    if (active == this) active = nullptr;
+    CtrlDeferredEvents* const previous = firing;
+    firing = this;
+    for (uint8_t i = 0; i < this->count; ++i) {
+        const Record record = this->records[i];
+        if (record.object != nullptr) record.object->fireEvent(record.type, record.value);
+    }
+    firing = previous;
+    this->count = 0;
+}
+
+uint8_t CtrlDeferredEvents::getCapacity() const
+{
+    return this->capacity;
+}
+
+bool CtrlDeferredEvents::isInUse() const
+{
+    return active == this || firing == this;
+}
+
+CtrlDeferredEvents::Phase::Phase(CtrlDeferredEvents* events) : events(events)
+{
+    if (events == nullptr || active != nullptr) return;
+    active = events;
+    this->owner = true;
+}
+
+CtrlDeferredEvents::Phase::~Phase()
+{
+    if (this->owner) this->events->fire();
+}
+
 const uint8_t DISCONNECTED = UINT8_MAX;
\ No newline at end of file
@@ -29,6 +29,7 @@
 #define CTRLBASE_H
 
 #include <Arduino.h>
+#include "CtrlEventQueue.h"
 
 #if defined(ARDUINO_ARCH_AVR)
     using CtrlInterruptState = uint8_t;
@@ -72,11 +73,59 @@
 
 class CtrlBase
 {
+    public:
+        enum Priority : uint8_t {
+            PRIORITY_HIGH, // Serviced on every time slice, e.g. encoders.
+            PRIORITY_NORMAL, // Serviced in round-robin order (default).
+            PRIORITY_LOW // Serviced every LOW_PRIORITY_INTERVAL rounds, e.g. potentiometers.
+        };
+
+        static constexpr uint8_t LOW_PRIORITY_INTERVAL = 4;
+
+        // Changes whenever the priority of any object changes.
+        static uint16_t priorityVersion;
+
     protected:
         bool enabled = true;
+        Priority priority = PRIORITY_NORMAL;
+        unsigned long lastActivity = 0; // millis() of the last input change.
+        CtrlEventQueue* eventQueue = nullptr;
+        uint8_t eventSource = 0;
+
+        /**
+        * @brief Record an input change, for the adaptive scan rate.
+        */
+        void markActivity(unsigned long now);
+
+        /**
+        * @brief Whether the input did not change for timeout milliseconds.
+        */
+        [[nodiscard]] bool isIdleFor(unsigned long now, unsigned long timeout) const;
+
+        /**
+        * @brief Push an event to the event queue, if the object has one.
+        *
+        * @return True when the event went to the queue (or was dropped), the
+        * callbacks must then not be called.
+        */
+        bool queueEvent(CtrlEvent::Type type, int32_t value = 0);
+
+        /**
+        * @brief Hold an event back until the end of a two-phase pass.
+        *
+        * @return True when the event is held back, the callbacks must then
+        * not be called yet: fireEvent() calls them later.
+        */
+        bool deferEvent(CtrlEvent::Type type, int32_t value = 0);
 
     public:
-        virtual ~CtrlBase() = default;
+        /**
+        * @brief Call the callbacks of an event that was held back, see deferEvent().
+        */
+        virtual void fireEvent(CtrlEvent::Type type, int32_t value);
+
+    public:
+        virtual ~CtrlBase();
 
         void enable();
 
@@ -85,6 +134,110 @@ class CtrlBase
         [[nodiscard]] bool isEnabled() const;
 
         [[nodiscard]] bool isDisabled() const;
+
+        /**
+        * @brief Set the scan priority of the object.
+        *
+        * Only affects time-sliced processing, see CtrlMux::process(count) &
+        * CtrlGroup::process(count).
+        *
+        * @param priority CtrlBase::PRIORITY_HIGH, PRIORITY_NORMAL (default) or PRIORITY_LOW.
+        */
+        void setPriority(Priority priority);
+
+        [[nodiscard]] Priority getPriority() const;
+
+        /**
+        * @brief Push events to a queue, instead of calling the callbacks.
+        *
+        * The object (and its group) callbacks are no longer called: process()
+        * only stores a small record of each event, and the application pops
+        * the events from the queue whenever it has time.
+        *
+        * @param queue The queue, nullptr to go back to the callbacks.
+        * @param source (optional) The id of the object in the events. Default is 0.
+        */
+        void setEventQueue(CtrlEventQueue* queue, uint8_t source = 0);
+};
+
+/*
+ * The events held back during the first phase of a two-phase pass, see
+ * CtrlMux::setTwoPhaseScan().
+ *
+ * While a buffer is active, objects only record their events. When the pass
+ * ends, the events are fired in the order they happened. Passes can nest
+ * (e.g. a group processing multiplexed objects): the outermost pass fires.
+ */
+class CtrlDeferredEvents
+{
+    public:
+        struct Record
+        {
+            CtrlBase* object;
+            CtrlEvent::Type type;
+            int32_t value;
+        };
+
+        /*
+         * Makes a buffer active for as long as it is in scope.
+         */
+        class Phase
+        {
+            protected:
+                CtrlDeferredEvents* events;
+                bool owner = false;
+
+            public:
+                explicit Phase(CtrlDeferredEvents* events);
+                ~Phase();
+                Phase(const Phase&) = delete;
+                Phase& operator=(const Phase&) = delete;
+        };
+
+    protected:
+        static CtrlDeferredEvents* active;
+        static CtrlDeferredEvents* firing;
+
+        Record* records = nullptr;
+        uint8_t capacity = 0;
+        uint8_t count = 0;
+
+    public:
+        /**
+        * @brief Instantiate a buffer for a number of events per pass.
+        *
+        * When a pass has more events, the rest fires right away.
+        */
+        explicit CtrlDeferredEvents(uint8_t capacity);
+
+        ~CtrlDeferredEvents();
+
+        CtrlDeferredEvents(const CtrlDeferredEvents&) = delete;
+        CtrlDeferredEvents& operator=(const CtrlDeferredEvents&) = delete;
+
+        /**
+        * @brief Hold an event back in the active buffer.
+        *
+        * @return false when no buffer is active, or it is full.
+        */
+        static bool defer(CtrlBase* object, CtrlEvent::Type type, int32_t value);
+
+        /**
+        * @brief Drop the held back events of an object, e.g. when it is destroyed.
+        */
+        static void forget(const CtrlBase* object);
+
+        /**
+        * @brief Fire all held back events, in order.
+        */
+        void fire();
+
+        [[nodiscard]] uint8_t getCapacity() const;
+
+        /**
+        * @brief Whether a pass is holding back or firing events of this buffer.
+        */
+        [[nodiscard]] bool isInUse() const;
 };
 
 extern const uint8_t DISCONNECTED;
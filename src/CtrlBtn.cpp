@@ -34,10 +34,11 @@ CtrlBtn::CtrlBtn(
     const CallbackFunction onPressCallback,
     const CallbackFunction onReleaseCallback,
     const CallbackFunction onDelayedReleaseCallback,
-    CtrlMux* mux
+    CtrlSource* mux
 ) : Muxable(mux)
 {
     this->sig = sig;
+    this->sigPin.attach(sig);
     this->bounceDuration = bounceDuration;
     this->onPressCallback = onPressCallback;
     this->onReleaseCallback = onReleaseCallback;
@@ -79,61 +80,346 @@ void CtrlBtn::setPinMode(const uint8_t pinModeType, const uint8_t resistorPull)
     }
 }
 
+void CtrlBtn::setDebounceSamples(const uint8_t samples)
+{
+    if (samples > 0) this->leadingEdge = false;
+    this->debounceSamples = samples;
+    this->resetIntegrator();
+}
+
+void CtrlBtn::setLeadingEdge(const bool enabled, const uint16_t lockout)
+{
+    if (enabled) this->setDebounceSamples(0);
+    this->leadingEdge = enabled;
+    this->lockoutDuration = lockout;
+    this->lockedOut = false;
+}
+
 void CtrlBtn::storePinState(const bool state)
+{
+    this->storePinState(state, CtrlClock::nowMicros());
+}
+
+void CtrlBtn::storePinState(const bool state, const unsigned long micros)
 {
     const auto irqState = ctrlSaveInterrupts();
-    this->isrPinState = state;
-    this->isrStatePending = true;
+    this->pushEdge(state, micros);
     ctrlRestoreInterrupts(irqState);
 }
 
+void CtrlBtn::pushEdge(const bool state, const uint32_t time)
+{
+    // When full, drop the oldest edge: the newest edges tell the current state.
+    if (this->edgeCount == EDGE_SLOTS) {
+        this->edgeHead = static_cast<uint8_t>((this->edgeHead + 1) % EDGE_SLOTS);
+        this->edgeCount = this->edgeCount - 1;
+    }
+    Edge& edge = this->edges[(this->edgeHead + this->edgeCount) % EDGE_SLOTS];
+    edge.time = time;
+    edge.state = state;
+    this->edgeCount = this->edgeCount + 1;
+    this->isrPinState = state;
+}
+
+CtrlBtn::~CtrlBtn()
+{
+    this->detachPinInterrupts();
+}
+
+bool CtrlBtn::attachPinInterrupts()
+{
+    if (this->isMuxed()) return false;
+    if (this->interruptsAttached) return true;
+    if (!this->isInitialized()) this->initialize();
+    this->isrPinState = this->sigPin.read();
+    if (!CtrlInterrupts::attach(this->sig, this)) return false;
+    this->interruptsAttached = true;
+    return true;
+}
+
+void CtrlBtn::detachPinInterrupts()
+{
+    if (!this->interruptsAttached) return;
+    CtrlInterrupts::detach(this);
+    this->interruptsAttached = false;
+}
+
+void CtrlBtn::onPinChange()
+{
+    this->pushEdge(this->sigPin.read(), CtrlClock::nowMicros());
+}
+
+bool CtrlBtn::needsProcessing() const
+{
+    if (!this->interruptsAttached || !this->initialized) return true;
+    if (this->isGesturePending()) return true;
+    // A pending edge, a pending debounce, or a change of the enabled state.
+    if (this->debounceSamples > 0 && this->integrator != (this->isPressed() ? this->debounceSamples : 0)) return true;
+    return this->edgeCount > 0 || this->lastState != this->currentState ||
+        this->isDisabled() || this->previouslyDisabled;
+}
+
 void CtrlBtn::process()
+{
+    unsigned long now = 0;
+    // The gestures share the timestamp of the state, when it has one.
+    const bool timed = this->processState(now);
+    this->processGestures(now, timed);
+}
+
+bool CtrlBtn::processState(unsigned long& now)
 {
     if (!this->isInitialized()) this->initialize();
+    if (this->interruptsAttached && !this->needsProcessing()) return false;
 
+    Edge pending[EDGE_SLOTS];
     const auto irqState = ctrlSaveInterrupts();
-    const bool pending = this->isrStatePending;
+    const uint8_t count = this->edgeCount;
+    for (uint8_t i = 0; i < count; ++i) {
+        pending[i] = this->edges[(this->edgeHead + i) % EDGE_SLOTS];
+    }
     const bool isrState = this->isrPinState;
-    this->isrStatePending = false;
+    this->edgeHead = 0;
+    this->edgeCount = 0;
     ctrlRestoreInterrupts(irqState);
+    // With pin interrupts, the last stored state is the pin state.
+    const bool stored = count > 0 || this->interruptsAttached;
     if (this->isDisabled()) {
         this->previouslyDisabled = true;
-        return;
+        return false;
+    }
+    if (this->debounceSamples > 0) {
+        this->processSample(stored ? isrState : this->processInput());
+        return false;
     }
-    const unsigned long currentTime = millis();
+    const unsigned long currentTime = CtrlClock::now();
+    now = currentTime;
     if (this->previouslyDisabled) {
         this->previouslyDisabled = false;
-        const bool reading = pending ? isrState : this->processInput();
+        const bool reading = stored ? isrState : this->processInput();
         this->currentState = reading;
         this->lastState = reading;
         this->debounceStart = currentTime;
         this->pressStartTime = currentTime;
-        return;
+        this->resetGestures(currentTime);
+        if (this->isGrouped() && this->isReleased()) this->group->setPressed(*this, false);
+        return true;
+    }
+    if (count > 0) {
+        // Replay the edges at their own time. The live clocks are read together to
+        // convert the edge times, then edges after the time of the pass (latched
+        // before this button got its turn) are taken to happen at that time.
+        const unsigned long liveTime = CtrlClock::live();
+        const uint32_t liveMicros = CtrlClock::nowMicros();
+        for (uint8_t i = 0; i < count; ++i) {
+            unsigned long edgeTime = liveTime - (liveMicros - pending[i].time) / 1000;
+            if (static_cast<long>(currentTime - edgeTime) < 0) edgeTime = currentTime;
+            if (this->leadingEdge) {
+                this->processLeadingEdge(pending[i].state, edgeTime);
+                continue;
+            }
+            // Every edge restarts the debounce: the bounces in between are not stored.
+            this->settle(edgeTime, this->debounceStart);
+            this->debounceStart = edgeTime;
+            this->lastState = pending[i].state;
+            this->edgeTimed = true;
+            this->markActivity(currentTime);
+        }
+    }
+    const bool reading = stored ? isrState : this->processInput();
+    if (this->leadingEdge) {
+        this->processLeadingEdge(reading, currentTime);
+        return true;
     }
-    const bool reading = pending ? isrState : this->processInput();
-    if (reading != this->lastState) {
+    if (count == 0 && reading != this->lastState) {
         this->debounceStart = currentTime;
+        this->edgeTimed = false;
+        this->markActivity(currentTime);
     }
     this->lastState = reading;
-    if (currentTime - this->debounceStart >= bounceDuration) {
-        if (reading != this->currentState) {
-            this->currentState = reading;
-            if (this->isPressed()) {
-                this->pressStartTime = currentTime;
-                this->onPress();
-            } else {
-                if (this->onDelayedReleaseCallback != nullptr &&
-                    currentTime - this->pressStartTime >= this->delayedReleaseDuration
-                ) {
-                    this->onDelayedRelease();
-                } else {
-                    this->onRelease();
-                }
-            }
+    // Edges tell the true time of a change, also when it settles on a later poll.
+    this->settle(currentTime, stored || this->edgeTimed ? this->debounceStart : currentTime);
+    if (this->lastState == this->currentState) this->edgeTimed = false;
+    return true;
+}
+
+void CtrlBtn::settle(const unsigned long now, const unsigned long eventTime)
+{
+    if (this->lastState == this->currentState) return;
+    if (now - this->debounceStart >= this->bounceDuration) {
+        this->changeState(this->lastState, eventTime);
+    }
+}
+
+void CtrlBtn::processSample(const bool reading)
+{
+    if (this->previouslyDisabled) {
+        this->previouslyDisabled = false;
+        this->currentState = reading;
+        this->lastState = reading;
+        this->resetIntegrator();
+        this->pressStartTime = CtrlClock::now();
+        this->resetGestures(this->pressStartTime);
+        if (this->isGrouped() && this->isReleased()) this->group->setPressed(*this, false);
+        return;
+    }
+    this->lastState = reading;
+    const bool pressedReading = this->resistorPull == PULL_UP ? reading == LOW : reading == HIGH;
+    const uint8_t rest = this->isPressed() ? this->debounceSamples : 0;
+    const bool leavesRest = this->integrator == rest;
+    if (pressedReading) {
+        if (this->integrator == this->debounceSamples) return;
+        ++this->integrator;
+    } else {
+        if (this->integrator == 0) return;
+        --this->integrator;
+    }
+    // The clock is only read when the count leaves its rest, or reaches the other end.
+    if (this->integrator == this->debounceSamples - rest) {
+        const unsigned long now = CtrlClock::now();
+        this->markActivity(now);
+        this->changeState(reading, now);
+    } else if (leavesRest) {
+        this->markActivity(CtrlClock::now());
+    }
+}
+
+void CtrlBtn::processLeadingEdge(const bool reading, const unsigned long now)
+{
+    if (reading != this->lastState) this->markActivity(now);
+    this->lastState = reading;
+    const uint16_t lockout = this->lockoutDuration > 0 ? this->lockoutDuration : this->bounceDuration;
+    if (this->lockedOut) {
+        if (now - this->debounceStart < lockout) return;
+        this->lockedOut = false;
+    }
+    if (reading == this->currentState) return;
+    this->debounceStart = now;
+    this->lockedOut = true;
+    this->changeState(reading, now);
+}
+
+void CtrlBtn::resetIntegrator()
+{
+    this->integrator = this->isPressed() ? this->debounceSamples : 0;
+}
+
+void CtrlBtn::changeState(const bool state, const unsigned long now)
+{
+    this->currentState = state;
+    // The group tracks the pressed buttons, also when the events go to a queue or are held back.
+    CtrlGroup* const group = this->isGrouped() ? this->group : nullptr;
+    if (group != nullptr) group->setPressed(*this, this->isPressed());
+    if (this->isPressed()) {
+        this->pressStartTime = now;
+        this->pressGesture(now);
+        this->onPress();
+        // After the press event, as long as the button is still in the group.
+        if (group != nullptr && this->isGrouped() && this->group == group) {
+            const uint32_t chord = group->matchChord();
+            if (chord != 0) this->onChord(chord);
+        }
+    } else {
+        // A queue always tells delayed releases apart.
+        if ((this->onDelayedReleaseCallback != nullptr || this->eventQueue != nullptr) &&
+            now - this->pressStartTime >= this->delayedReleaseDuration
+        ) {
+            this->onDelayedRelease();
+        } else {
+            this->onRelease();
         }
+        this->releaseGesture(now);
     }
 }
 
+bool CtrlBtn::hasClickHandler() const
+{
+    return this->onClickCallback != nullptr || (this->isGrouped() && this->group->onClickCallback != nullptr);
+}
+
+bool CtrlBtn::hasLongPressHandler() const
+{
+    return this->onLongPressCallback != nullptr || (this->isGrouped() && this->group->onLongPressCallback != nullptr);
+}
+
+bool CtrlBtn::hasRepeatHandler() const
+{
+    return this->onRepeatCallback != nullptr || (this->isGrouped() && this->group->onRepeatCallback != nullptr);
+}
+
+bool CtrlBtn::isGesturePending() const
+{
+    if (this->isReleased()) return this->clickCount > 0;
+    return (this->hasLongPressHandler() && (this->gestureFlags & GESTURE_LONG_PRESSED) == 0) ||
+        this->hasRepeatHandler();
+}
+
+void CtrlBtn::resetGestures(const unsigned long now)
+{
+    this->clickCount = 0;
+    this->gestureFlags = 0;
+    this->gestureTime = now;
+}
+
+void CtrlBtn::pressGesture(const unsigned long now)
+{
+    // A press after the click window starts a new multi-click.
+    if (this->clickCount > 0 && now - this->gestureTime > this->clickWindow) this->fireClicks();
+    this->gestureFlags = 0;
+    this->gestureTime = now;
+    this->repeatCurrent = this->repeatInterval;
+}
+
+void CtrlBtn::releaseGesture(const unsigned long now)
+{
+    if (this->gestureFlags != 0) {
+        this->clickCount = 0;
+        return;
+    }
+    if (!this->hasClickHandler()) return;
+    ++this->clickCount;
+    this->gestureTime = now;
+    if (this->clickCount >= MAX_CLICKS) this->fireClicks();
+}
+
+void CtrlBtn::processGestures(unsigned long now, const bool timed)
+{
+    if (this->isDisabled() || !this->initialized || !this->isGesturePending()) return;
+    if (!timed) now = CtrlClock::now();
+    if (this->isReleased()) {
+        if (now - this->gestureTime >= this->clickWindow) this->fireClicks();
+        return;
+    }
+    if (this->hasLongPressHandler() && (this->gestureFlags & GESTURE_LONG_PRESSED) == 0 &&
+        now - this->pressStartTime >= this->longPressDuration
+    ) {
+        this->gestureFlags |= GESTURE_LONG_PRESSED;
+        this->clickCount = 0;
+        this->onLongPress();
+    }
+    if (!this->hasRepeatHandler()) return;
+    const bool repeated = (this->gestureFlags & GESTURE_REPEATED) != 0;
+    const uint16_t wait = repeated ? this->repeatCurrent : this->repeatDelay;
+    if (now - this->gestureTime < wait) return;
+    // Keep the cadence, but a late call does not fire a burst of repeats.
+    this->gestureTime = now - this->gestureTime >= 2UL * wait ? now : this->gestureTime + wait;
+    if (repeated && this->repeatCurrent > this->repeatMinInterval) {
+        const uint16_t step = this->repeatCurrent / 8 > 0 ? this->repeatCurrent / 8 : 1;
+        this->repeatCurrent = this->repeatCurrent - step > this->repeatMinInterval ?
+            this->repeatCurrent - step : this->repeatMinInterval;
+    }
+    this->gestureFlags |= GESTURE_REPEATED;
+    this->clickCount = 0;
+    this->onRepeat();
+}
+
+void CtrlBtn::fireClicks()
+{
+    const uint8_t clicks = this->clickCount;
+    this->clickCount = 0;
+    this->onClick(clicks);
+}
+
 bool CtrlBtn::isPressed() const
 {
     if (this->resistorPull == PULL_UP) {
@@ -170,26 +456,81 @@ void CtrlBtn::setDelayedReleaseDuration(const unsigned long duration)
     this->delayedReleaseDuration = duration;
 }
 
+void CtrlBtn::setOnClick(const ClickCallbackFunction callback)
+{
+    this->onClickCallback = callback;
+}
+
+void CtrlBtn::setClickWindow(const uint16_t window)
+{
+    this->clickWindow = window;
+}
+
+void CtrlBtn::setOnLongPress(const CallbackFunction callback)
+{
+    this->onLongPressCallback = callback;
+}
+
+void CtrlBtn::setLongPressDuration(const uint16_t duration)
+{
+    this->longPressDuration = duration;
+}
+
+void CtrlBtn::setOnRepeat(const CallbackFunction callback)
+{
+    this->onRepeatCallback = callback;
+}
+
+void CtrlBtn::setRepeat(const uint16_t delay, const uint16_t interval, const uint16_t minInterval)
+{
+    this->repeatDelay = delay;
+    this->repeatInterval = interval;
+    this->repeatMinInterval = minInterval > 0 && minInterval < interval ? minInterval : interval;
+}
+
 void CtrlBtn::initialize()
 {
-    if (!this->isMuxed()) pinMode(sig, this->pinModeType);
+    if (!this->isMuxed()) this->sigPin.setMode(this->pinModeType);
     this->currentState = this->processInput();
     this->lastState = currentState;
+    this->resetIntegrator();
     this->initialized = true;
 }
 
 bool CtrlBtn::isInitialized() const { return this->initialized; }
 
+uint8_t CtrlBtn::getMuxChannel() const { return this->sig; }
+
+uint8_t CtrlBtn::getMuxPinMode() const { return this->pinModeType; }
+
+bool CtrlBtn::getMuxIdleLevel() const { return this->resistorPull == PULL_UP; }
+
+uint8_t CtrlBtn::getScanPriority() const { return this->priority; }
+
+bool CtrlBtn::isScanIdle(const unsigned long now, const unsigned long timeout) const { return this->isIdleFor(now, timeout); }
+
 bool CtrlBtn::processInput()
 {
     if (this->isMuxed()) {
         return this->mux->readBtnSig(this->sig, this->pinModeType);
     }
-    return digitalRead(this->sig);
+    return this->sigPin.read();
+}
+
+void CtrlBtn::fireEvent(const CtrlEvent::Type type, const int32_t value)
+{
+    if (type == CtrlEvent::PRESS) this->onPress();
+    else if (type == CtrlEvent::RELEASE) this->onRelease();
+    else if (type == CtrlEvent::DELAYED_RELEASE) this->onDelayedRelease();
+    else if (type == CtrlEvent::CLICK) this->onClick(static_cast<uint8_t>(value));
+    else if (type == CtrlEvent::LONG_PRESS) this->onLongPress();
+    else if (type == CtrlEvent::REPEAT) this->onRepeat();
+    else if (type == CtrlEvent::CHORD) this->onChord(static_cast<uint32_t>(value));
 }
 
 void CtrlBtn::onPress()
 {
+    if (this->queueEvent(CtrlEvent::PRESS) || this->deferEvent(CtrlEvent::PRESS)) return;
     const auto callback = this->onPressCallback;
     if (this->isGrouped() && this->group->onPressCallback) {
         this->group->onPressCallback(*this);
@@ -201,6 +542,7 @@ void CtrlBtn::onPress()
 
 void CtrlBtn::onRelease()
 {
+    if (this->queueEvent(CtrlEvent::RELEASE) || this->deferEvent(CtrlEvent::RELEASE)) return;
     const auto callback = this->onReleaseCallback;
     if (this->isGrouped() && this->group->onReleaseCallback) {
         this->group->onReleaseCallback(*this);
@@ -212,6 +554,7 @@ void CtrlBtn::onRelease()
 
 void CtrlBtn::onDelayedRelease()
 {
+    if (this->queueEvent(CtrlEvent::DELAYED_RELEASE) || this->deferEvent(CtrlEvent::DELAYED_RELEASE)) return;
     const auto callback = this->onDelayedReleaseCallback;
     if (this->isGrouped() && this->group->onDelayedReleaseCallback) {
         this->group->onDelayedReleaseCallback(*this);
@@ -219,4 +562,48 @@ void CtrlBtn::onDelayedRelease()
     if (callback) {
         callback();
     }
+}
+
+void CtrlBtn::onClick(const uint8_t clicks)
+{
+    if (this->queueEvent(CtrlEvent::CLICK, clicks) || this->deferEvent(CtrlEvent::CLICK, clicks)) return;
+    const auto callback = this->onClickCallback;
+    if (this->isGrouped() && this->group->onClickCallback) {
+        this->group->onClickCallback(*this, clicks);
+    }
+    if (callback) {
+        callback(clicks);
+    }
+}
+
+void CtrlBtn::onLongPress()
+{
+    if (this->queueEvent(CtrlEvent::LONG_PRESS) || this->deferEvent(CtrlEvent::LONG_PRESS)) return;
+    const auto callback = this->onLongPressCallback;
+    if (this->isGrouped() && this->group->onLongPressCallback) {
+        this->group->onLongPressCallback(*this);
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+void CtrlBtn::onChord(const uint32_t mask)
+{
+    if (this->queueEvent(CtrlEvent::CHORD, static_cast<int32_t>(mask)) || this->deferEvent(CtrlEvent::CHORD, static_cast<int32_t>(mask))) return;
+    if (this->isGrouped() && this->group->onChordCallback) {
+        this->group->onChordCallback(mask);
+    }
+}
+
+void CtrlBtn::onRepeat()
+{
+    if (this->queueEvent(CtrlEvent::REPEAT) || this->deferEvent(CtrlEvent::REPEAT)) return;
+    const auto callback = this->onRepeatCallback;
+    if (this->isGrouped() && this->group->onRepeatCallback) {
+        this->group->onRepeatCallback(*this);
+    }
+    if (callback) {
+        callback();
+    }
 }
\ No newline at end of file
@@ -30,30 +30,73 @@
 
 #include <Arduino.h>
 #include "CtrlBase.h"
+#include "CtrlClock.h"
+#include "CtrlInterrupts.h"
 #include "CtrlMux.h"
+#include "CtrlPinIO.h"
 #include "Groupable.h"
 #include "Muxable.h"
 
-class CtrlBtn : public CtrlBase, public Muxable, public Groupable
+#ifndef CTRL_BUTTON_EDGE_SLOTS
+    #define CTRL_BUTTON_EDGE_SLOTS 4 // The number of edges a button keeps between two process() calls.
+#endif
+
+class CtrlBtn : public CtrlBase, public Muxable, public Groupable, public CtrlPinChangeHandler
 {
     protected:
         uint8_t sig; // Signal pin
+        CtrlPin sigPin;
         uint8_t pinModeType = INPUT_PULLUP;
         uint8_t resistorPull = PULL_UP;
         bool currentState = HIGH;
         bool lastState = HIGH;
         unsigned long debounceStart = 0;
         uint16_t bounceDuration; // In milliseconds
+        uint8_t debounceSamples = 0; // When > 0, debounce on sample counts instead of bounceDuration.
+        uint8_t integrator = 0; // Counts from 0 (released) up to debounceSamples (pressed).
+        bool leadingEdge = false; // Fire on the first edge, then ignore the pin for the lockout.
+        bool lockedOut = false;
+        uint16_t lockoutDuration = 0; // In milliseconds, 0 for the bounce duration.
         bool initialized = false;
         unsigned long pressStartTime = 0;
         unsigned long delayedReleaseDuration = 500; // default 500 ms
         bool previouslyDisabled = false;
-        volatile bool isrPinState = HIGH;
-        volatile bool isrStatePending = false;
+        struct Edge
+        {
+            uint32_t time; // CtrlClock::nowMicros() of the edge.
+            bool state;
+        };
+
+        static constexpr uint8_t EDGE_SLOTS = CTRL_BUTTON_EDGE_SLOTS;
+
+        volatile bool isrPinState = HIGH; // The state of the last edge.
+        Edge edges[EDGE_SLOTS] = {}; // Ring of the edges since the last process() call.
+        volatile uint8_t edgeHead = 0; // The slot of the oldest edge.
+        volatile uint8_t edgeCount = 0;
+        bool edgeTimed = false; // The pending state came from an edge: debounceStart is its time.
+        bool interruptsAttached = false;
         using CallbackFunction = void (*)();
+        using ClickCallbackFunction = void (*)(uint8_t clicks);
         CallbackFunction onPressCallback = nullptr;
         CallbackFunction onReleaseCallback = nullptr;
         CallbackFunction onDelayedReleaseCallback = nullptr;
+        ClickCallbackFunction onClickCallback = nullptr;
+        CallbackFunction onLongPressCallback = nullptr;
+        CallbackFunction onRepeatCallback = nullptr;
+
+        static constexpr uint8_t MAX_CLICKS = 3; // Triple click, a 3rd click fires right away.
+        static constexpr uint8_t GESTURE_LONG_PRESSED = 0x01; // The long press of this press fired.
+        static constexpr uint8_t GESTURE_REPEATED = 0x02; // This press repeated.
+
+        uint16_t clickWindow = 250; // In milliseconds, from a release to the next press.
+        uint16_t longPressDuration = 500; // In milliseconds.
+        uint16_t repeatDelay = 500; // In milliseconds, from the press to the first repeat.
+        uint16_t repeatInterval = 100; // In milliseconds, between the first repeats.
+        uint16_t repeatMinInterval = 100; // In milliseconds, the repeats speed up to this.
+        uint16_t repeatCurrent = 0; // The current repeat interval.
+        uint8_t clickCount = 0; // Clicks of the pending multi-click.
+        uint8_t gestureFlags = 0;
+        unsigned long gestureTime = 0; // The release of a pending multi-click, or the next repeat.
 
     public:
         /**
@@ -67,7 +110,7 @@ class CtrlBtn : public CtrlBase, public Muxable, public Groupable
         * @param onPressCallback (optional) The on press callback handler. Default is nullptr.
         * @param onReleaseCallback (optional) The on release callback handler. Default is nullptr.
         * @param onDelayedReleaseCallback (optional) The on delayed release callback handler. Default is nullptr.
-        * @param mux (CtrlMux) (optional) The multiplexer the button is connected to. Default is nullptr.
+        * @param mux (CtrlSource) (optional) The multiplexer (or other source, e.g. CtrlShiftIn) the button is connected to. Default is nullptr.
         * @return A new instance of the CtrlBtn class.
         */
         CtrlBtn(
@@ -76,7 +119,7 @@ class CtrlBtn : public CtrlBase, public Muxable, public Groupable
             CallbackFunction onPressCallback = nullptr,
             CallbackFunction onReleaseCallback = nullptr,
             CallbackFunction onDelayedReleaseCallback = nullptr,
-            CtrlMux* mux = nullptr
+            CtrlSource* mux = nullptr
         );
 
         /**
@@ -90,6 +133,33 @@ class CtrlBtn : public CtrlBase, public Muxable, public Groupable
         */
         void setPinMode(uint8_t pinModeType, uint8_t resistorPull = PULL_UP);
 
+        /**
+        * @brief Debounce on a number of samples instead of the bounce duration.
+        *
+        * Every process() call is one sample: it counts up while the button
+        * reads pressed, and down while it reads released. The button is
+        * pressed once the count reaches samples, and released once it is back
+        * at 0. No clock is read while nothing changes, and the debounce time
+        * follows the scan rate: samples times the time between process() calls.
+        *
+        * @param samples (uint8_t) The number of samples, 0 (default) to debounce on the bounce duration.
+        */
+        void setDebounceSamples(uint8_t samples);
+
+        /**
+        * @brief Fire on the first edge, instead of after the bounce duration.
+        *
+        * A press (or release) is reported as soon as the pin changes, then
+        * the pin is ignored for the lockout, so the bounces that follow are
+        * not seen. When the pin reads differently at the end of the lockout
+        * (e.g. a tap shorter than the lockout), that change is reported
+        * right away. Turns off the sample count debounce.
+        *
+        * @param enabled (bool) Enable or disable leading edge debounce.
+        * @param lockout (uint16_t) (optional) The lockout in milliseconds, 0 (default) for the bounce duration.
+        */
+        void setLeadingEdge(bool enabled, uint16_t lockout = 0);
+
         /**
         * @brief The process method should be called within the loop method.
         * It handles all functionality.
@@ -108,6 +178,51 @@ class CtrlBtn : public CtrlBase, public Muxable, public Groupable
         */
         void storePinState(bool state);
 
+        /**
+        * @brief Store a pin state with the time of its edge, from an ISR or interrupt handler.
+        *
+        * Up to CTRL_BUTTON_EDGE_SLOTS (default 4) edges are kept between two
+        * process() calls, the oldest are dropped when there are more. The
+        * debounce and the delayed release are timed from the edges.
+        *
+        * @param state The pin state (HIGH or LOW).
+        * @param micros The time of the edge, from micros() (or CtrlClock::nowMicros()).
+        */
+        void storePinState(bool state, unsigned long micros);
+
+        /**
+        * @brief Let a CHANGE interrupt on the pin tell the button about presses.
+        *
+        * The library installs the interrupt: it stores the pin state & the time
+        * of the edge, and marks the button dirty. process() then returns right
+        * away (without reading the pin) until the pin changed, or a debounce is
+        * pending, and a CtrlGroup skips the button altogether.
+        * At most CTRL_INTERRUPT_SLOTS pins (default 16) can be attached.
+        *
+        * @return False when the button is multiplexed, the pin has no
+        * interrupt, or all interrupt slots are taken.
+        */
+        bool attachPinInterrupts();
+
+        /**
+        * @brief Go back to reading the pin on every process() call.
+        */
+        void detachPinInterrupts();
+
+        /**
+        * @brief Whether process() has anything to do.
+        *
+        * Always true, unless pin interrupts are attached.
+        */
+        [[nodiscard]] bool needsProcessing() const override;
+
+        /**
+        * @brief Call the callbacks of an event held back by a two-phase pass.
+        */
+        void fireEvent(CtrlEvent::Type type, int32_t value) override;
+
+        ~CtrlBtn() override;
+
         /**
         * @brief Find out if a button is currently being pressed.
         *
@@ -161,13 +276,98 @@ class CtrlBtn : public CtrlBase, public Muxable, public Groupable
         */
         void setDelayedReleaseDuration(unsigned long duration);
 
+        /**
+        * @brief Set the on click handler.
+        *
+        * Pass in a handler that is called with the number of clicks (1, 2 or 3)
+        * once a single, double or triple click is complete: when the click
+        * window passed after a release without a new press, or right away on
+        * the 3rd click. A press that long pressed or repeated is not a click.
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnClick(ClickCallbackFunction callback);
+
+        /**
+        * @brief Set the time from a release to the next press of a multi-click.
+        *
+        * @param window The window in milliseconds (default is 250ms).
+        */
+        void setClickWindow(uint16_t window);
+
+        /**
+        * @brief Set the on long press handler.
+        *
+        * Pass in a handler that is called once while the button is held, as
+        * soon as it is held for the long press duration (default is 500ms).
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnLongPress(CallbackFunction callback);
+
+        /**
+        * @brief Set the amount of time for a long press.
+        *
+        * @param duration The duration in milliseconds.
+        */
+        void setLongPressDuration(uint16_t duration);
+
+        /**
+        * @brief Set the on repeat handler.
+        *
+        * Pass in a handler that is called repeatedly while the button is held,
+        * like the keys of a keyboard, see setRepeat().
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnRepeat(CallbackFunction callback);
+
+        /**
+        * @brief Set the timing of the repeats while the button is held.
+        *
+        * The first repeat is delay after the press, then every interval. With
+        * a minInterval below the interval, every repeat is an eighth sooner
+        * than the last, until the repeats are minInterval apart.
+        *
+        * @param delay (uint16_t) The delay before the first repeat in milliseconds (default is 500ms).
+        * @param interval (uint16_t) The interval between the first repeats in milliseconds (default is 100ms).
+        * @param minInterval (uint16_t) (optional) The shortest interval in milliseconds, 0 (default) for no acceleration.
+        */
+        void setRepeat(uint16_t delay, uint16_t interval, uint16_t minInterval = 0);
+
     protected:
         void initialize();
         [[nodiscard]] bool isInitialized() const;
+        [[nodiscard]] uint8_t getMuxChannel() const override;
+        [[nodiscard]] uint8_t getMuxPinMode() const override;
+        [[nodiscard]] bool getMuxIdleLevel() const override;
+        [[nodiscard]] uint8_t getScanPriority() const override;
+        [[nodiscard]] bool isScanIdle(unsigned long now, unsigned long timeout) const override;
+        void onPinChange() override;
         virtual bool processInput();
+        bool processState(unsigned long& now);
+        void processSample(bool reading);
+        void processLeadingEdge(bool reading, unsigned long now);
+        void pushEdge(bool state, uint32_t time);
+        void settle(unsigned long now, unsigned long eventTime);
+        void resetIntegrator();
+        void changeState(bool state, unsigned long now);
+        [[nodiscard]] bool hasClickHandler() const;
+        [[nodiscard]] bool hasLongPressHandler() const;
+        [[nodiscard]] bool hasRepeatHandler() const;
+        [[nodiscard]] bool isGesturePending() const;
+        void resetGestures(unsigned long now);
+        void pressGesture(unsigned long now);
+        void releaseGesture(unsigned long now);
+        void processGestures(unsigned long now, bool timed);
+        void fireClicks();
         virtual void onPress();
         virtual void onRelease();
         virtual void onDelayedRelease();
+        virtual void onClick(uint8_t clicks);
+        virtual void onLongPress();
+        virtual void onRepeat();
+        virtual void onChord(uint32_t mask);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,317 @@
+/*!
+ *  @file       CtrlBtnBank.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLBTNBANK_H
+#define CTRLBTNBANK_H
+
+#include <Arduino.h>
+#include "CtrlBase.h"
+#include "CtrlClock.h"
+#include "CtrlSource.h"
+#include "Muxable.h"
+
+/*
+ * A bank of 8, 16 or 32 buttons on consecutive channels of a source, e.g. a
+ * multiplexer or a shift register chain, debounced all at once.
+ *
+ * The bank reads all its channels as one bitmask and debounces them with
+ * vertical counters: a 2 bit counter per button, stored as 2 bit planes, so
+ * one sample of the whole bank takes a handful of bitwise operations. A
+ * button changes state after 4 samples in a row that differ from its
+ * debounced state, any sample that matches resets its counter.
+ *
+ * It produces the same press, release & delayed release events as CtrlBtn,
+ * with the index of the button in the bank (0 is the first channel).
+ */
+template <typename Mask>
+class CtrlBtnBank : public CtrlBase, public Muxable
+{
+    static_assert(
+        sizeof(Mask) == 1 || sizeof(Mask) == 2 || sizeof(Mask) == 4,
+        "CtrlBtnBank supports uint8_t, uint16_t or uint32_t masks."
+    );
+
+    public:
+        static constexpr uint8_t WIDTH = sizeof(Mask) * 8;
+        static constexpr uint8_t SAMPLES = 4; // Samples in a row before a button changes state.
+
+        using CallbackFunction = void (*)(uint8_t index);
+
+    protected:
+        uint8_t channel; // First channel
+        uint8_t count;
+        Mask used;
+        uint8_t pinModeType = INPUT_PULLUP;
+        uint8_t resistorPull = PULL_UP;
+        Mask pressed = 0; // Debounced state, a set bit is a pressed button.
+        Mask count0 = 0; // Low bit plane of the vertical counters.
+        Mask count1 = 0; // High bit plane of the vertical counters.
+        uint16_t sampleInterval; // In milliseconds
+        unsigned long lastSample = 0;
+        unsigned long pressStartTime[WIDTH] = {};
+        unsigned long delayedReleaseDuration = 500; // default 500 ms
+        bool initialized = false;
+        bool previouslyDisabled = false;
+        CallbackFunction onPressCallback = nullptr;
+        CallbackFunction onReleaseCallback = nullptr;
+        CallbackFunction onDelayedReleaseCallback = nullptr;
+
+        /**
+        * @brief Turn pin levels into pressed bits.
+        */
+        Mask toPressed(const uint32_t levels) const
+        {
+            const Mask bits = static_cast<Mask>(levels);
+            return static_cast<Mask>((this->resistorPull == PULL_UP ? ~bits : bits) & this->used);
+        }
+
+        /**
+        * @brief Take the current levels as the debounced state, without events.
+        */
+        void resync(const Mask sample, const unsigned long now)
+        {
+            this->pressed = sample;
+            this->count0 = 0;
+            this->count1 = 0;
+            for (uint8_t i = 0; i < this->count; ++i) this->pressStartTime[i] = now;
+            this->lastSample = now;
+            this->initialized = true;
+        }
+
+        void dispatch(Mask toggled, const unsigned long now)
+        {
+            for (uint8_t i = 0; toggled != 0; ++i, toggled >>= 1) {
+                if (!(toggled & 1)) continue;
+                CtrlEvent::Type type = CtrlEvent::RELEASE;
+                if (this->pressed & static_cast<Mask>(Mask(1) << i)) {
+                    this->pressStartTime[i] = now;
+                    type = CtrlEvent::PRESS;
+                } else if ((this->onDelayedReleaseCallback != nullptr || this->eventQueue != nullptr) &&
+                    now - this->pressStartTime[i] >= this->delayedReleaseDuration
+                ) {
+                    type = CtrlEvent::DELAYED_RELEASE;
+                }
+                if (this->queueEvent(type, i) || this->deferEvent(type, i)) continue;
+                this->fireEvent(type, i);
+            }
+        }
+
+        [[nodiscard]] uint8_t getMuxChannel() const override { return this->channel; }
+
+        [[nodiscard]] uint8_t getMuxPinMode() const override { return this->pinModeType; }
+        [[nodiscard]] bool getMuxIdleLevel() const override { return this->resistorPull == PULL_UP; }
+
+        [[nodiscard]] uint16_t getMuxChannelMask() const override
+        {
+            if (this->channel >= 16) return 0;
+            return static_cast<uint16_t>(static_cast<uint32_t>(this->used) << this->channel);
+        }
+
+    public:
+        /**
+        * @brief Instantiate a button bank object.
+        *
+        * @param channel (uint8_t) The channel of the first button on the source.
+        * @param count (uint8_t) The number of buttons, at most the width of the mask.
+        * @param bounceDuration (uint16_t) The bounce duration in milliseconds. The bank samples every bounceDuration / 3 milliseconds.
+        * @param onPressCallback (optional) The on press callback handler. Default is nullptr.
+        * @param onReleaseCallback (optional) The on release callback handler. Default is nullptr.
+        * @param onDelayedReleaseCallback (optional) The on delayed release callback handler. Default is nullptr.
+        * @param mux (CtrlSource) (optional) The source the buttons are connected to. Default is nullptr, feed the bank with update() instead.
+        * @return A new instance of the CtrlBtnBank class.
+        */
+        CtrlBtnBank(
+            const uint8_t channel,
+            const uint8_t count,
+            const uint16_t bounceDuration,
+            const CallbackFunction onPressCallback = nullptr,
+            const CallbackFunction onReleaseCallback = nullptr,
+            const CallbackFunction onDelayedReleaseCallback = nullptr,
+            CtrlSource* mux = nullptr
+        ) : Muxable(mux),
+            channel(channel),
+            count(count == 0 ? 1 : count > WIDTH ? WIDTH : count),
+            // 4 equal samples span 3 intervals.
+            sampleInterval(static_cast<uint16_t>((bounceDuration + SAMPLES - 2) / (SAMPLES - 1))),
+            onPressCallback(onPressCallback),
+            onReleaseCallback(onReleaseCallback),
+            onDelayedReleaseCallback(onDelayedReleaseCallback)
+        {
+            this->used = this->count == WIDTH ? static_cast<Mask>(~Mask(0)) : static_cast<Mask>((Mask(1) << this->count) - 1);
+        }
+
+        /**
+        * @brief Sets the pinMode of all buttons, see CtrlBtn::setPinMode().
+        *
+        * @param pinModeType Set to INPUT, INPUT_PULLUP or INPUT_PULLDOWN.
+        * @param resistorPull (optional) With INPUT, 'PULL_UP' (default) or 'PULL_DOWN'.
+        */
+        void setPinMode(const uint8_t pinModeType, const uint8_t resistorPull = PULL_UP)
+        {
+            if (pinModeType != INPUT && pinModeType != INPUT_PULLUP && pinModeType != INPUT_PULLDOWN) return;
+            if (resistorPull != PULL_DOWN && resistorPull != PULL_UP) return;
+            this->pinModeType = pinModeType;
+            if (pinModeType == INPUT_PULLUP) this->resistorPull = PULL_UP;
+            else if (pinModeType == INPUT_PULLDOWN) this->resistorPull = PULL_DOWN;
+            else this->resistorPull = resistorPull;
+            this->initialized = false;
+        }
+
+        /**
+        * @brief The process method should be called within the loop method.
+        *
+        * Reads all channels from the source in one go, once every sample interval.
+        */
+        void process() override
+        {
+            if (!this->isMuxed()) return;
+            if (this->isDisabled()) {
+                this->previouslyDisabled = true;
+                return;
+            }
+            const unsigned long now = CtrlClock::now();
+            if (this->initialized && now - this->lastSample < this->sampleInterval) return;
+            this->sample(this->mux->readBtnBits(this->channel, this->count, this->pinModeType), now);
+        }
+
+        /**
+        * @brief Feed the bank one sample of pin levels, e.g. read from a port register.
+        *
+        * Bypasses the sample interval: every call is one sample.
+        *
+        * @param levels The pin levels, bit 0 is the first button.
+        * @return The buttons that changed state.
+        */
+        Mask update(const uint32_t levels)
+        {
+            return this->sample(levels, CtrlClock::now());
+        }
+
+        /**
+        * @brief Debounce one sample.
+        *
+        * @param levels The pin levels, bit 0 is the first button.
+        * @param now The time of the sample, from CtrlClock::now().
+        * @return The buttons that changed state.
+        */
+        Mask sample(const uint32_t levels, const unsigned long now)
+        {
+            const Mask reading = this->toPressed(levels);
+            if (this->isDisabled()) {
+                this->previouslyDisabled = true;
+                return 0;
+            }
+            if (!this->initialized || this->previouslyDisabled) {
+                this->previouslyDisabled = false;
+                this->resync(reading, now);
+                return 0;
+            }
+            this->lastSample = now;
+            // Count the samples that differ from the debounced state, reset the others.
+            const Mask delta = reading ^ this->pressed;
+            if (delta == 0) {
+                this->count0 = 0;
+                this->count1 = 0;
+                return 0;
+            }
+            this->markActivity(now);
+            this->count1 = static_cast<Mask>((this->count1 ^ this->count0) & delta);
+            this->count0 = static_cast<Mask>(~this->count0 & delta);
+            // A counter wrapped to 0 on its 4th sample in a row.
+            const Mask toggled = static_cast<Mask>(delta & ~(this->count0 | this->count1));
+            if (toggled == 0) return 0;
+            this->pressed ^= toggled;
+            this->dispatch(toggled, now);
+            return toggled;
+        }
+
+        /**
+        * @brief Find out if a button is currently being pressed.
+        *
+        * @param index The index of the button in the bank.
+        */
+        [[nodiscard]] bool isPressed(const uint8_t index) const
+        {
+            return index < this->count && (this->pressed >> index & 1);
+        }
+
+        /**
+        * @brief Find out if a button is currently not being pressed.
+        *
+        * @param index The index of the button in the bank.
+        */
+        [[nodiscard]] bool isReleased(const uint8_t index) const
+        {
+            return index < this->count && !(this->pressed >> index & 1);
+        }
+
+        /**
+        * @brief The debounced state of all buttons, a set bit is a pressed button.
+        */
+        [[nodiscard]] Mask getPressed() const { return this->pressed; }
+
+        /**
+        * @brief The number of buttons in the bank.
+        */
+        [[nodiscard]] uint8_t getCount() const { return this->count; }
+
+        void setOnPress(const CallbackFunction callback) { this->onPressCallback = callback; }
+
+        void setOnRelease(const CallbackFunction callback) { this->onReleaseCallback = callback; }
+
+        /**
+        * @brief Set the on delayed release handler, see CtrlBtn::setOnDelayedRelease().
+        */
+        void setOnDelayedRelease(const CallbackFunction callback) { this->onDelayedReleaseCallback = callback; }
+
+        /**
+        * @brief Set the amount of time for a delayed release, see CtrlBtn::setDelayedReleaseDuration().
+        *
+        * @param duration The duration in milliseconds.
+        */
+        void setDelayedReleaseDuration(const unsigned long duration) { this->delayedReleaseDuration = duration; }
+
+        /**
+        * @brief Call the callback of an event, value is the index of the button.
+        */
+        void fireEvent(const CtrlEvent::Type type, const int32_t value) override
+        {
+            const auto index = static_cast<uint8_t>(value);
+            if (type == CtrlEvent::PRESS && this->onPressCallback) this->onPressCallback(index);
+            else if (type == CtrlEvent::RELEASE && this->onReleaseCallback) this->onReleaseCallback(index);
+            else if (type == CtrlEvent::DELAYED_RELEASE && this->onDelayedReleaseCallback) this->onDelayedReleaseCallback(index);
+        }
+
+        [[nodiscard]] uint8_t getScanPriority() const override { return this->priority; }
+
+        [[nodiscard]] bool isScanIdle(const unsigned long now, const unsigned long timeout) const override
+        {
+            return this->isIdleFor(now, timeout);
+        }
+};
+
+#endif // CTRLBTNBANK_H
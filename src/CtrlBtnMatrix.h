@@ -0,0 +1,395 @@
+/*!
+ *  @file       CtrlBtnMatrix.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLBTNMATRIX_H
+#define CTRLBTNMATRIX_H
+
+#include <Arduino.h>
+#include "CtrlBase.h"
+#include "CtrlClock.h"
+#include "CtrlDelay.h"
+#include "CtrlPinIO.h"
+#include "CtrlSource.h"
+
+/*
+ * The smallest mask that holds a row of the matrix.
+ */
+template <bool Wide>
+struct CtrlBtnMatrixRow
+{
+    using Mask = uint8_t;
+};
+
+template <>
+struct CtrlBtnMatrixRow<true>
+{
+    using Mask = uint16_t;
+};
+
+/*
+ * A matrix of up to 16 x 16 buttons: the row pins are driven low one at a
+ * time, and the column pins (or channels of a source) read the buttons of
+ * that row, so a pass over 64 buttons takes 8 row strobes.
+ *
+ * Rows that are not strobed float (INPUT), the columns are pulled up: a
+ * pressed button reads low. Like CtrlBtnBank, all rows are debounced as
+ * bitmasks with vertical counters, a button changes state after 4 samples in
+ * a row that differ from its debounced state.
+ *
+ * Without a diode per button, 3 buttons on the corners of a rectangle make the
+ * 4th corner read pressed too (ghosting). When 2 rows read 2 or more of the
+ * same columns, the state of those buttons is kept until the ambiguity is gone.
+ *
+ * It produces the same press, release & delayed release events as CtrlBtn,
+ * with the index of the button: row * Cols + column.
+ */
+template <uint8_t Rows, uint8_t Cols>
+class CtrlBtnMatrix : public CtrlBase
+{
+    static_assert(Rows >= 1 && Rows <= 16 && Cols >= 1 && Cols <= 16, "CtrlBtnMatrix supports 1 to 16 rows & columns.");
+
+    public:
+        static constexpr uint8_t SAMPLES = 4; // Samples in a row before a button changes state.
+
+        using Mask = typename CtrlBtnMatrixRow<(Cols > 8)>::Mask;
+        using CallbackFunction = void (*)(uint8_t index);
+
+    protected:
+        static constexpr Mask USED = static_cast<Mask>(Cols == sizeof(Mask) * 8 ? ~Mask(0) : (Mask(1) << Cols) - 1);
+
+        CtrlPin rowPins[Rows];
+        CtrlPin colPins[Cols];
+        CtrlSource* columns = nullptr; // Reads the columns from a source instead of the column pins.
+        uint8_t colChannel = 0;
+        Mask pressed[Rows] = {}; // Debounced state per row, a set bit is a pressed button.
+        Mask count0[Rows] = {}; // Low bit plane of the vertical counters.
+        Mask count1[Rows] = {}; // High bit plane of the vertical counters.
+        Mask ghosts[Rows] = {}; // The buttons of the last sample that were ambiguous.
+        bool ghostDetection = true;
+        uint16_t sampleInterval; // In milliseconds
+        uint32_t settleTime = 1000; // In nanoseconds, from a row strobe to reading the columns.
+        unsigned long lastSample = 0;
+        unsigned long pressStartTime[Rows * Cols] = {};
+        unsigned long delayedReleaseDuration = 500; // default 500 ms
+        bool initialized = false;
+        bool previouslyDisabled = false;
+        CallbackFunction onPressCallback = nullptr;
+        CallbackFunction onReleaseCallback = nullptr;
+        CallbackFunction onDelayedReleaseCallback = nullptr;
+
+        void initialize()
+        {
+            CtrlDelay::begin();
+            for (CtrlPin& row : this->rowPins) row.setMode(INPUT);
+            if (this->columns == nullptr) {
+                for (CtrlPin& col : this->colPins) col.setMode(INPUT_PULLUP);
+            }
+        }
+
+        /**
+        * @brief Strobe one row, and read its pressed buttons.
+        */
+        Mask readRow(const uint8_t row)
+        {
+            const CtrlPin& pin = this->rowPins[row];
+            // Low before output: the pin never drives the row high.
+            pin.write(LOW);
+            pin.setMode(OUTPUT);
+            CtrlDelay::wait(this->settleTime);
+            uint32_t levels = 0;
+            if (this->columns != nullptr) {
+                levels = this->columns->readBtnBits(this->colChannel, Cols, INPUT_PULLUP);
+            } else {
+                for (uint8_t col = 0; col < Cols; ++col) {
+                    if (this->colPins[col].read()) levels |= 1UL << col;
+                }
+            }
+            pin.setMode(INPUT);
+            return static_cast<Mask>(~levels & USED);
+        }
+
+        /**
+        * @brief Keep the buttons that 2 rows share 2 or more columns of, those may be ghosts.
+        */
+        void suppressGhosts(Mask (&reading)[Rows])
+        {
+            for (Mask& ghost : this->ghosts) ghost = 0;
+            if (!this->ghostDetection) return;
+            for (uint8_t a = 0; a < Rows; ++a) {
+                // A row with less than 2 buttons cannot be part of a rectangle.
+                if ((reading[a] & (reading[a] - 1)) == 0) continue;
+                for (uint8_t b = a + 1; b < Rows; ++b) {
+                    const Mask shared = reading[a] & reading[b];
+                    if ((shared & (shared - 1)) == 0) continue;
+                    this->ghosts[a] |= shared;
+                    this->ghosts[b] |= shared;
+                }
+            }
+            for (uint8_t row = 0; row < Rows; ++row) {
+                const Mask ghost = this->ghosts[row];
+                reading[row] = static_cast<Mask>((reading[row] & ~ghost) | (this->pressed[row] & ghost));
+            }
+        }
+
+        /**
+        * @brief Take the readings as the debounced state, without events.
+        */
+        void resync(const Mask (&reading)[Rows], const unsigned long now)
+        {
+            for (uint8_t row = 0; row < Rows; ++row) {
+                this->pressed[row] = reading[row];
+                this->count0[row] = 0;
+                this->count1[row] = 0;
+            }
+            for (unsigned long& start : this->pressStartTime) start = now;
+            this->lastSample = now;
+            this->initialized = true;
+        }
+
+        void dispatch(const uint8_t row, Mask toggled, const unsigned long now)
+        {
+            for (uint8_t col = 0; toggled != 0; ++col, toggled >>= 1) {
+                if (!(toggled & 1)) continue;
+                const auto index = static_cast<uint8_t>(row * Cols + col);
+                CtrlEvent::Type type = CtrlEvent::RELEASE;
+                if (this->pressed[row] & static_cast<Mask>(Mask(1) << col)) {
+                    this->pressStartTime[index] = now;
+                    type = CtrlEvent::PRESS;
+                } else if ((this->onDelayedReleaseCallback != nullptr || this->eventQueue != nullptr) &&
+                    now - this->pressStartTime[index] >= this->delayedReleaseDuration
+                ) {
+                    type = CtrlEvent::DELAYED_RELEASE;
+                }
+                if (this->queueEvent(type, index) || this->deferEvent(type, index)) continue;
+                this->fireEvent(type, index);
+            }
+        }
+
+    public:
+        /**
+        * @brief Instantiate a button matrix on pins.
+        *
+        * @param rowPins The row pins, driven low one at a time.
+        * @param colPins The column pins, read with the internal pull-ups.
+        * @param bounceDuration (uint16_t) The bounce duration in milliseconds. The matrix is scanned every bounceDuration / 3 milliseconds.
+        * @param onPressCallback (optional) The on press callback handler. Default is nullptr.
+        * @param onReleaseCallback (optional) The on release callback handler. Default is nullptr.
+        * @param onDelayedReleaseCallback (optional) The on delayed release callback handler. Default is nullptr.
+        * @return A new instance of the CtrlBtnMatrix class.
+        */
+        CtrlBtnMatrix(
+            const uint8_t (&rowPins)[Rows],
+            const uint8_t (&colPins)[Cols],
+            const uint16_t bounceDuration,
+            const CallbackFunction onPressCallback = nullptr,
+            const CallbackFunction onReleaseCallback = nullptr,
+            const CallbackFunction onDelayedReleaseCallback = nullptr
+        ) : CtrlBtnMatrix(rowPins, nullptr, 0, bounceDuration, onPressCallback, onReleaseCallback, onDelayedReleaseCallback)
+        {
+            for (uint8_t col = 0; col < Cols; ++col) this->colPins[col].attach(colPins[col]);
+        }
+
+        /**
+        * @brief Instantiate a button matrix with its columns on a source, e.g. a shift register chain.
+        *
+        * The source is read while a row is strobed: the matrix must not be added
+        * to the source, it reads the columns itself on process().
+        *
+        * @param rowPins The row pins, driven low one at a time.
+        * @param columns (CtrlSource) The source the columns are connected to, with pull-ups.
+        * @param colChannel (uint8_t) The channel of the first column on the source.
+        * @param bounceDuration (uint16_t) The bounce duration in milliseconds. The matrix is scanned every bounceDuration / 3 milliseconds.
+        * @param onPressCallback (optional) The on press callback handler. Default is nullptr.
+        * @param onReleaseCallback (optional) The on release callback handler. Default is nullptr.
+        * @param onDelayedReleaseCallback (optional) The on delayed release callback handler. Default is nullptr.
+        * @return A new instance of the CtrlBtnMatrix class.
+        */
+        CtrlBtnMatrix(
+            const uint8_t (&rowPins)[Rows],
+            CtrlSource* columns,
+            const uint8_t colChannel,
+            const uint16_t bounceDuration,
+            const CallbackFunction onPressCallback = nullptr,
+            const CallbackFunction onReleaseCallback = nullptr,
+            const CallbackFunction onDelayedReleaseCallback = nullptr
+        ) : columns(columns),
+            colChannel(colChannel),
+            // 4 equal samples span 3 intervals.
+            sampleInterval(static_cast<uint16_t>((bounceDuration + SAMPLES - 2) / (SAMPLES - 1))),
+            onPressCallback(onPressCallback),
+            onReleaseCallback(onReleaseCallback),
+            onDelayedReleaseCallback(onDelayedReleaseCallback)
+        {
+            for (uint8_t row = 0; row < Rows; ++row) this->rowPins[row].attach(rowPins[row]);
+        }
+
+        /**
+        * @brief The process method should be called within the loop method.
+        *
+        * Strobes every row once per sample interval.
+        */
+        void process()
+        {
+            if (this->isDisabled()) {
+                this->previouslyDisabled = true;
+                return;
+            }
+            const unsigned long now = CtrlClock::now();
+            if (this->initialized && now - this->lastSample < this->sampleInterval) return;
+            this->scan(now);
+        }
+
+        /**
+        * @brief Strobe every row & debounce the readings, regardless of the sample interval.
+        *
+        * @param now The time of the scan, from CtrlClock::now().
+        * @return True when a button changed state.
+        */
+        bool scan(const unsigned long now)
+        {
+            if (this->isDisabled()) {
+                this->previouslyDisabled = true;
+                return false;
+            }
+            if (!this->initialized) this->initialize();
+            Mask reading[Rows];
+            for (uint8_t row = 0; row < Rows; ++row) reading[row] = this->readRow(row);
+            if (!this->initialized || this->previouslyDisabled) {
+                this->previouslyDisabled = false;
+                this->resync(reading, now);
+                return false;
+            }
+            this->lastSample = now;
+            this->suppressGhosts(reading);
+            bool changed = false;
+            for (uint8_t row = 0; row < Rows; ++row) {
+                // Count the samples that differ from the debounced state, reset the others.
+                const Mask delta = reading[row] ^ this->pressed[row];
+                if (delta == 0) {
+                    this->count0[row] = 0;
+                    this->count1[row] = 0;
+                    continue;
+                }
+                this->markActivity(now);
+                this->count1[row] = static_cast<Mask>((this->count1[row] ^ this->count0[row]) & delta);
+                this->count0[row] = static_cast<Mask>(~this->count0[row] & delta);
+                // A counter wrapped to 0 on its 4th sample in a row.
+                const Mask toggled = static_cast<Mask>(delta & ~(this->count0[row] | this->count1[row]));
+                if (toggled == 0) continue;
+                this->pressed[row] ^= toggled;
+                this->dispatch(row, toggled, now);
+                changed = true;
+            }
+            return changed;
+        }
+
+        /**
+        * @brief Detect & suppress ghost buttons (default), disable for a matrix with diodes.
+        *
+        * @param enabled (bool) Enable or disable ghost detection.
+        */
+        void setGhostDetection(const bool enabled) { this->ghostDetection = enabled; }
+
+        /**
+        * @brief Set the time from a row strobe to reading the columns.
+        *
+        * @param settleTime (uint32_t) The settle time in nanoseconds (default is 1000ns).
+        */
+        void setSettleTimeNs(const uint32_t settleTime) { this->settleTime = settleTime; }
+
+        /**
+        * @brief Whether the last scan held buttons back as possible ghosts.
+        */
+        [[nodiscard]] bool hasGhosts() const
+        {
+            for (const Mask ghost : this->ghosts) {
+                if (ghost != 0) return true;
+            }
+            return false;
+        }
+
+        /**
+        * @brief Find out if a button is currently being pressed.
+        *
+        * @param index The index of the button: row * Cols + column.
+        */
+        [[nodiscard]] bool isPressed(const uint8_t index) const
+        {
+            return index < Rows * Cols && (this->pressed[index / Cols] >> (index % Cols) & 1);
+        }
+
+        /**
+        * @brief Find out if a button is currently not being pressed.
+        *
+        * @param index The index of the button: row * Cols + column.
+        */
+        [[nodiscard]] bool isReleased(const uint8_t index) const
+        {
+            return index < Rows * Cols && !(this->pressed[index / Cols] >> (index % Cols) & 1);
+        }
+
+        /**
+        * @brief The debounced state of a row, a set bit is a pressed button.
+        *
+        * @param row The row.
+        */
+        [[nodiscard]] Mask getPressed(const uint8_t row) const { return row < Rows ? this->pressed[row] : 0; }
+
+        /**
+        * @brief The number of buttons in the matrix.
+        */
+        [[nodiscard]] uint16_t getCount() const { return Rows * Cols; }
+
+        void setOnPress(const CallbackFunction callback) { this->onPressCallback = callback; }
+
+        void setOnRelease(const CallbackFunction callback) { this->onReleaseCallback = callback; }
+
+        /**
+        * @brief Set the on delayed release handler, see CtrlBtn::setOnDelayedRelease().
+        */
+        void setOnDelayedRelease(const CallbackFunction callback) { this->onDelayedReleaseCallback = callback; }
+
+        /**
+        * @brief Set the amount of time for a delayed release, see CtrlBtn::setDelayedReleaseDuration().
+        *
+        * @param duration The duration in milliseconds.
+        */
+        void setDelayedReleaseDuration(const unsigned long duration) { this->delayedReleaseDuration = duration; }
+
+        /**
+        * @brief Call the callback of an event, value is the index of the button.
+        */
+        void fireEvent(const CtrlEvent::Type type, const int32_t value) override
+        {
+            const auto index = static_cast<uint8_t>(value);
+            if (type == CtrlEvent::PRESS && this->onPressCallback) this->onPressCallback(index);
+            else if (type == CtrlEvent::RELEASE && this->onReleaseCallback) this->onReleaseCallback(index);
+            else if (type == CtrlEvent::DELAYED_RELEASE && this->onDelayedReleaseCallback) this->onDelayedReleaseCallback(index);
+        }
+};
+
+#endif // CTRLBTNMATRIX_H
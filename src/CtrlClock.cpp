@@ -0,0 +1,79 @@
+/*!
+ *  @file       CtrlClock.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CtrlClock.h"
+
+CtrlClock::TimeFunction CtrlClock::millisSource = nullptr;
+CtrlClock::TimeFunction CtrlClock::microsSource = nullptr;
+unsigned long CtrlClock::latched = 0;
+uint8_t CtrlClock::depth = 0;
+uint16_t CtrlClock::sequence = 0;
+
+unsigned long CtrlClock::now()
+{
+    return depth > 0 ? latched : live();
+}
+
+unsigned long CtrlClock::live()
+{
+    return millisSource != nullptr ? millisSource() : millis();
+}
+
+unsigned long CtrlClock::nowMicros()
+{
+    return microsSource != nullptr ? microsSource() : micros();
+}
+
+void CtrlClock::latch()
+{
+    if (depth == 0) {
+        latched = live();
+        if (++sequence == 0) ++sequence;
+    }
+    if (depth < UINT8_MAX) ++depth;
+}
+
+void CtrlClock::release()
+{
+    if (depth > 0) --depth;
+}
+
+bool CtrlClock::isLatched()
+{
+    return depth > 0;
+}
+
+uint16_t CtrlClock::getPass()
+{
+    return depth > 0 ? sequence : 0;
+}
+
+void CtrlClock::setSource(const TimeFunction millisSource, const TimeFunction microsSource)
+{
+    CtrlClock::millisSource = millisSource;
+    CtrlClock::microsSource = microsSource;
+}
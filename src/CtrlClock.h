@@ -0,0 +1,113 @@
+/*!
+ *  @file       CtrlClock.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLCLOCK_H
+#define CTRLCLOCK_H
+
+#include <Arduino.h>
+
+/*
+ * The time all controls read.
+ *
+ * Sources (CtrlMux, CtrlShiftIn, ...) and groups latch the time once at the
+ * start of every pass: all objects of the pass then share one timestamp,
+ * instead of each reading millis() (with interrupts masked on AVR) itself.
+ * Outside a pass, e.g. a button processed on its own, now() reads the clock.
+ *
+ * The time functions can be replaced, e.g. by a simulated clock in tests.
+ */
+class CtrlClock
+{
+    public:
+        using TimeFunction = unsigned long (*)();
+
+        /*
+         * Latches the time for as long as it is in scope.
+         */
+        class Pass
+        {
+            public:
+                Pass() { CtrlClock::latch(); }
+                ~Pass() { CtrlClock::release(); }
+                Pass(const Pass&) = delete;
+                Pass& operator=(const Pass&) = delete;
+        };
+
+    protected:
+        static TimeFunction millisSource;
+        static TimeFunction microsSource;
+        static unsigned long latched;
+        static uint8_t depth; // Passes can nest, e.g. a group processing multiplexed objects.
+        static uint16_t sequence; // Counts the outermost passes, skipping 0.
+
+    public:
+        /**
+        * @brief The time in milliseconds, latched during a pass.
+        */
+        [[nodiscard]] static unsigned long now();
+
+        /**
+        * @brief The time in milliseconds, never latched. Use this in interrupts.
+        */
+        [[nodiscard]] static unsigned long live();
+
+        /**
+        * @brief The time in microseconds, never latched, e.g. for time budgets.
+        */
+        [[nodiscard]] static unsigned long nowMicros();
+
+        /**
+        * @brief Latch the time until the matching release().
+        */
+        static void latch();
+
+        static void release();
+
+        /**
+        * @brief Whether the time is latched.
+        */
+        [[nodiscard]] static bool isLatched();
+
+        /**
+        * @brief The number of the current pass, 0 outside a pass.
+        *
+        * Nested passes share the number of the outermost one, so a source read
+        * several times in a pass, e.g. by the objects of a CtrlGroup, can tell
+        * its capture is still current.
+        */
+        [[nodiscard]] static uint16_t getPass();
+
+        /**
+        * @brief Replace the time functions.
+        *
+        * @param millisSource The time in milliseconds, nullptr (default) for millis().
+        * @param microsSource (optional) The time in microseconds, nullptr (default) for micros().
+        */
+        static void setSource(TimeFunction millisSource = nullptr, TimeFunction microsSource = nullptr);
+};
+
+#endif // CTRLCLOCK_H
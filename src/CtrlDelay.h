@@ -0,0 +1,165 @@
+/*!
+ *  @file       CtrlDelay.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLDELAY_H
+#define CTRLDELAY_H
+
+#include <Arduino.h>
+
+/*
+ * Settle delay backends.
+ *
+ * Multiplexer switch intervals are waited on with one of the backends below,
+ * selected at compile time:
+ *
+ * - Cortex-M3/M4/M7    CtrlDelayCycleCounter: busy-waits on the DWT cycle counter,
+ *                      with nanosecond resolution (e.g. Teensy 3.x/4.x, Due, STM32).
+ * - AVR                CtrlDelayAvrLoop: a cycle exact 4 cycle loop (250 ns at 16 MHz).
+ * - (other)            CtrlDelayMicros: delayMicroseconds & micros(), rounded up
+ *                      to whole microseconds.
+ * - CTRL_DELAY_MOCK    CtrlDelayMock: the mock clock of the native test environment.
+ *
+ * Every backend provides:
+ * - begin(): prepares the timer, may be called more than once.
+ * - wait(ns): blocks for at least ns nanoseconds.
+ * - now(): a timestamp in backend specific ticks.
+ * - waitSince(start, ns): blocks until at least ns nanoseconds have passed since now() returned start.
+ * - FINE_TIMESTAMPS: whether now() is fine enough for waitSince() to not pad short intervals.
+ */
+
+// Whole cycles in ns nanoseconds at the given clock speed, rounded up, without overflowing 32 bits.
+inline uint32_t ctrlNanosToCycles(const uint32_t ns, const uint32_t hz)
+{
+    const uint32_t mhz = hz / 1000000UL;
+    return (ns / 1000) * mhz + ((ns % 1000) * mhz + 999) / 1000;
+}
+
+struct CtrlDelayMicros
+{
+    // micros() only counts in steps of 4 (16 MHz) or 8 (8 MHz) microseconds on AVR boards.
+#if defined(ARDUINO_ARCH_AVR) && defined(F_CPU) && F_CPU < 16000000L
+    static constexpr uint8_t MICROS_RESOLUTION = 8;
+#elif defined(ARDUINO_ARCH_AVR)
+    static constexpr uint8_t MICROS_RESOLUTION = 4;
+#else
+    static constexpr uint8_t MICROS_RESOLUTION = 1;
+#endif
+    static constexpr bool FINE_TIMESTAMPS = MICROS_RESOLUTION == 1;
+
+    static void begin() { }
+
+    static void wait(const uint32_t ns)
+    {
+        if (ns > 0) delayMicroseconds((ns + 999) / 1000);
+    }
+
+    static uint32_t now() { return micros(); }
+
+    static void waitSince(const uint32_t start, const uint32_t ns)
+    {
+        const uint32_t us = (ns + 999) / 1000 + MICROS_RESOLUTION;
+        while (static_cast<uint32_t>(micros()) - start < us) { }
+    }
+};
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+struct CtrlDelayCycleCounter
+{
+    static constexpr bool FINE_TIMESTAMPS = true;
+
+    static volatile uint32_t& demcr() { return *reinterpret_cast<volatile uint32_t*>(0xE000EDFC); }
+    static volatile uint32_t& dwtCtrl() { return *reinterpret_cast<volatile uint32_t*>(0xE0001000); }
+    static volatile uint32_t& cyccnt() { return *reinterpret_cast<volatile uint32_t*>(0xE0001004); }
+
+    // The Teensy 4.x clock can be changed at runtime.
+    static uint32_t cpuHz()
+    {
+#if defined(__IMXRT1062__)
+        return F_CPU_ACTUAL;
+#else
+        return F_CPU;
+#endif
+    }
+
+    static void begin()
+    {
+        demcr() |= (1UL << 24);  // TRCENA: enable the DWT unit.
+        dwtCtrl() |= 1UL;        // CYCCNTENA: start the cycle counter.
+    }
+
+    static uint32_t now() { return cyccnt(); }
+
+    static void waitSince(const uint32_t start, const uint32_t ns)
+    {
+        const uint32_t cycles = ctrlNanosToCycles(ns, cpuHz());
+        while (cyccnt() - start < cycles) { }
+    }
+
+    static void wait(const uint32_t ns) { waitSince(now(), ns); }
+};
+#endif
+
+#if defined(ARDUINO_ARCH_AVR)
+#include <util/delay_basic.h>
+
+struct CtrlDelayAvrLoop
+{
+    // TCNT0, which micros() is built on, ticks every 4 us as well: no finer timestamps without taking a timer.
+    static constexpr bool FINE_TIMESTAMPS = false;
+
+    static void begin() { }
+
+    static void wait(uint32_t ns)
+    {
+        // _delay_loop_2 takes 4 cycles per iteration.
+        uint32_t iterations = (ctrlNanosToCycles(ns, F_CPU) + 3) / 4;
+        while (iterations > 0) {
+            const uint16_t chunk = iterations > 0xffff ? 0xffff : static_cast<uint16_t>(iterations);
+            _delay_loop_2(chunk);
+            iterations -= chunk;
+        }
+    }
+
+    // There is no free running cycle counter, so timestamps fall back to micros().
+    static uint32_t now() { return CtrlDelayMicros::now(); }
+
+    static void waitSince(const uint32_t start, const uint32_t ns) { CtrlDelayMicros::waitSince(start, ns); }
+};
+#endif
+
+#if defined(CTRL_DELAY_MOCK)
+    #include "CtrlDelayMock.h"
+    using CtrlDelay = CtrlDelayMock;
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+    using CtrlDelay = CtrlDelayCycleCounter;
+#elif defined(ARDUINO_ARCH_AVR)
+    using CtrlDelay = CtrlDelayAvrLoop;
+#else
+    using CtrlDelay = CtrlDelayMicros;
+#endif
+
+#endif // CTRLDELAY_H
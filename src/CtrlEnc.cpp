@@ -33,11 +33,13 @@ CtrlEnc::CtrlEnc(
     const uint8_t dt,
     const CallbackFunction onTurnLeftCallback,
     const CallbackFunction onTurnRightCallback,
-    CtrlMux* mux
+    CtrlSource* mux
 ) : Muxable(mux)
 {
     this->clk = clk;
     this->dt = dt;
+    this->clkPin.attach(clk);
+    this->dtPin.attach(dt);
     this->onTurnLeftCallback = onTurnLeftCallback;
     this->onTurnRightCallback = onTurnRightCallback;
 }
@@ -71,9 +73,57 @@ void CtrlEnc::storePinStates(const bool clkState, const bool dtState)
     ctrlRestoreInterrupts(irqState);
 }
 
+CtrlEnc::~CtrlEnc()
+{
+    this->detachPinInterrupts();
+}
+
+bool CtrlEnc::attachPinInterrupts()
+{
+    if (this->isMuxed()) return false;
+    if (this->interruptsAttached) return true;
+    if (!this->isInitialized()) this->initialize();
+    if (!CtrlInterrupts::attach(this->clk, this) || !CtrlInterrupts::attach(this->dt, this)) {
+        CtrlInterrupts::detach(this);
+        return false;
+    }
+    this->interruptsAttached = true;
+    return true;
+}
+
+void CtrlEnc::detachPinInterrupts()
+{
+    if (!this->interruptsAttached) return;
+    CtrlInterrupts::detach(this);
+    this->interruptsAttached = false;
+    this->isrSteps = 0;
+    this->isrEdgePending = false;
+}
+
+void CtrlEnc::onPinChange()
+{
+    bool moved = false;
+    const int8_t step = this->readEncoderFromIsr(this->clkPin.read(), this->dtPin.read(), moved);
+    if (step != 0 && this->isrSteps > INT8_MIN && this->isrSteps < INT8_MAX) this->isrSteps += step;
+    if (!moved) return;
+    // Handed to processSteps(), so the idle scan sees the edge time, not the next pass.
+    this->isrEdgeTime = CtrlClock::live();
+    this->isrEdgePending = true;
+}
+
+bool CtrlEnc::needsProcessing() const
+{
+    if (!this->interruptsAttached || !this->initialized) return true;
+    return this->isrSteps != 0 || this->isrEdgePending || this->isDisabled() || this->previouslyDisabled;
+}
+
 void CtrlEnc::process()
 {
     if (!this->isInitialized()) this->initialize();
+    if (this->interruptsAttached) {
+        this->processSteps();
+        return;
+    }
 
     const auto irqState = ctrlSaveInterrupts();
     const bool pending = this->isrStatePending;
@@ -91,9 +141,11 @@ void CtrlEnc::process()
         this->values[1] = 0;
         return;
     }
+    bool moved = false;
     const int8_t direction = pending
-        ? this->readEncoderFromIsr(clkSnap, dtSnap)
+        ? this->readEncoderFromIsr(clkSnap, dtSnap, moved)
         : this->readEncoder();
+    if (moved) this->markActivity(CtrlClock::now());
     if (direction < 0) {
         this->onTurnLeft();
     } else if (direction > 0) {
@@ -101,6 +153,29 @@ void CtrlEnc::process()
     }
 }
 
+void CtrlEnc::processSteps()
+{
+    const auto irqState = ctrlSaveInterrupts();
+    int8_t steps = this->isrSteps;
+    const bool edge = this->isrEdgePending;
+    const unsigned long edgeTime = this->isrEdgeTime;
+    this->isrSteps = 0;
+    this->isrEdgePending = false;
+    ctrlRestoreInterrupts(irqState);
+    if (edge) this->markActivity(edgeTime);
+    if (this->isDisabled()) {
+        this->previouslyDisabled = true;
+        return;
+    }
+    if (this->previouslyDisabled) {
+        // Drop the steps taken while disabled.
+        this->previouslyDisabled = false;
+        return;
+    }
+    for (; steps < 0; ++steps) this->onTurnLeft();
+    for (; steps > 0; --steps) this->onTurnRight();
+}
+
 bool CtrlEnc::isTurningLeft() const { return this->values[0] == 0x0b; }
 
 bool CtrlEnc::isTurningRight() const { return this->values[0] == 0x07; }
@@ -117,13 +192,31 @@ void CtrlEnc::setOnTurnRight(const CallbackFunction callback)
 
 void CtrlEnc::initialize()
 {
-    if (!this->isMuxed()) pinMode(clk, this->pinModeType);
-    if (!this->isMuxed()) pinMode(dt, this->pinModeType);
+    if (!this->isMuxed()) this->clkPin.setMode(this->pinModeType);
+    if (!this->isMuxed()) this->dtPin.setMode(this->pinModeType);
     this->initialized = true;
 }
 
 bool CtrlEnc::isInitialized() const { return this->initialized; }
 
+uint8_t CtrlEnc::getMuxChannel() const { return this->clk; }
+
+uint8_t CtrlEnc::getMuxPinMode() const { return this->pinModeType; }
+
+bool CtrlEnc::getMuxIdleLevel() const { return this->resistorPull == PULL_UP; }
+
+uint8_t CtrlEnc::getScanPriority() const { return this->priority; }
+
+bool CtrlEnc::isScanIdle(const unsigned long now, const unsigned long timeout) const { return this->isIdleFor(now, timeout); }
+
+uint16_t CtrlEnc::getMuxChannelMask() const
+{
+    uint16_t mask = 0;
+    if (this->clk < 16) mask |= static_cast<uint16_t>(1u << this->clk);
+    if (this->dt < 16) mask |= static_cast<uint16_t>(1u << this->dt);
+    return mask;
+}
+
 void CtrlEnc::processInput()
 {
     bool clkState, dtState;
@@ -132,8 +225,8 @@ void CtrlEnc::processInput()
         clkState = this->mux->readEncClk(this->clk, this->pinModeType);
         dtState = this->mux->readEncDt(this->dt, this->pinModeType);
     } else {
-        clkState = digitalRead(clk);
-        dtState = digitalRead(dt);
+        clkState = this->clkPin.read();
+        dtState = this->dtPin.read();
     }
 
     if (this->resistorPull == PULL_DOWN) {
@@ -151,10 +244,13 @@ int8_t CtrlEnc::readEncoder()
 {
     this->values[0] <<= 2;
     this->processInput();
-    return decodeStep();
+    bool moved = false;
+    const int8_t step = decodeStep(moved);
+    if (moved) this->markActivity(CtrlClock::now());
+    return step;
 }
 
-int8_t CtrlEnc::readEncoderFromIsr(bool clkState, bool dtState)
+int8_t CtrlEnc::readEncoderFromIsr(bool clkState, bool dtState, bool& moved)
 {
     if (this->resistorPull == PULL_DOWN) {
         clkState = !clkState;
@@ -163,14 +259,15 @@ int8_t CtrlEnc::readEncoderFromIsr(bool clkState, bool dtState)
     this->values[0] <<= 2;
     if (clkState) this->values[0] |= 0x01;
     if (dtState) this->values[0] |= 0x02;
-    return decodeStep();
+    return decodeStep(moved);
 }
 
-int8_t CtrlEnc::decodeStep()
+int8_t CtrlEnc::decodeStep(bool& moved)
 {
     static constexpr int8_t table[] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
     this->values[0] &= 0x0f;
-    if (table[this->values[0]]) {
+    moved = table[this->values[0]] != 0;
+    if (moved) {
         this->values[1] <<= 4;
         this->values[1] |= this->values[0];
         if ((this->values[1] & 0xff) == 0x2b) return -1;
@@ -179,8 +276,15 @@ int8_t CtrlEnc::decodeStep()
     return 0;
 }
 
+void CtrlEnc::fireEvent(const CtrlEvent::Type type, int32_t)
+{
+    if (type == CtrlEvent::TURN_LEFT) this->onTurnLeft();
+    else if (type == CtrlEvent::TURN_RIGHT) this->onTurnRight();
+}
+
 void CtrlEnc::onTurnLeft()
 {
+    if (this->queueEvent(CtrlEvent::TURN_LEFT) || this->deferEvent(CtrlEvent::TURN_LEFT)) return;
     const auto callback = this->onTurnLeftCallback;
     if (this->isGrouped() && this->group->onTurnLeftCallback) {
         this->group->onTurnLeftCallback(*this);
@@ -192,6 +296,7 @@ void CtrlEnc::onTurnLeft()
 
 void CtrlEnc::onTurnRight()
 {
+    if (this->queueEvent(CtrlEvent::TURN_RIGHT) || this->deferEvent(CtrlEvent::TURN_RIGHT)) return;
     const auto callback = this->onTurnRightCallback;
     if (this->isGrouped() && this->group->onTurnRightCallback) {
         this->group->onTurnRightCallback(*this);
@@ -30,15 +30,20 @@
 
 #include <Arduino.h>
 #include "CtrlBase.h"
+#include "CtrlClock.h"
+#include "CtrlInterrupts.h"
 #include "CtrlMux.h"
+#include "CtrlPinIO.h"
 #include "Groupable.h"
 #include "Muxable.h"
 
-class CtrlEnc : public CtrlBase, public Muxable, public Groupable
+class CtrlEnc : public CtrlBase, public Muxable, public Groupable, public CtrlPinChangeHandler
 {
     protected:
         uint8_t clk; // CLK pin
         uint8_t dt; // DT pin
+        CtrlPin clkPin;
+        CtrlPin dtPin;
         uint8_t pinModeType = INPUT_PULLUP;
         uint8_t resistorPull = PULL_UP;
         uint8_t values[2] = { 0, 0 };
@@ -47,6 +52,10 @@ class CtrlEnc : public CtrlBase, public Muxable, public Groupable
         volatile bool isrClkState = HIGH;
         volatile bool isrDtState = HIGH;
         volatile bool isrStatePending = false;
+        volatile int8_t isrSteps = 0; // Decoded by the pin change interrupts, not yet processed.
+        volatile bool isrEdgePending = false;
+        volatile unsigned long isrEdgeTime = 0; // millis() of the last decoded transition, for markActivity.
+        bool interruptsAttached = false;
         using CallbackFunction = void (*)();
         CallbackFunction onTurnLeftCallback = nullptr;
         CallbackFunction onTurnRightCallback = nullptr;
@@ -62,7 +71,7 @@ class CtrlEnc : public CtrlBase, public Muxable, public Groupable
         * @param dt (uint8_t) The DT signal pin of the encoder.
         * @param onTurnLeftCallback (optional) The on turn left callback handler. Default is nullptr.
         * @param onTurnRightCallback (optional) The on turn right callback handler. Default is nullptr.
-        * @param mux (CtrlMux) (optional) The multiplexer the encoder is connected to. Default is nullptr.
+        * @param mux (CtrlSource) (optional) The multiplexer (or other source, e.g. CtrlShiftIn) the encoder is connected to. Default is nullptr.
         * @return A new instance of the CtrlEnc class.
         *
         * @note When connected to a multiplexer, CLK and DT are read as two separate channel
@@ -71,13 +80,15 @@ class CtrlEnc : public CtrlBase, public Muxable, public Groupable
         * DT seen at time T+delay), which can cause missed or incorrect step detection.
         * For reliable high-speed encoding, connect the encoder directly to GPIO pins and
         * use hardware interrupts (attachInterrupt) on the CLK pin instead.
+        * Setting the multiplexer to CtrlMux::SNAPSHOT mode narrows the gap: both
+        * channels are then sampled in one sweep, before any object is processed.
         */
         CtrlEnc(
             uint8_t clk,
             uint8_t dt,
             CallbackFunction onTurnLeftCallback = nullptr,
             CallbackFunction onTurnRightCallback = nullptr,
-            CtrlMux* mux = nullptr
+            CtrlSource* mux = nullptr
         );
 
         /**
@@ -109,6 +120,39 @@ class CtrlEnc : public CtrlBase, public Muxable, public Groupable
         */
         void storePinStates(bool clkState, bool dtState);
 
+        /**
+        * @brief Let CHANGE interrupts on the CLK & DT pins decode the encoder.
+        *
+        * The library installs the interrupts: every edge is decoded right
+        * away, so no step is lost between process() calls. process() then
+        * only calls the turn handlers for the decoded steps, and returns right
+        * away when there are none. A CtrlGroup skips the encoder altogether.
+        * Takes 2 of the CTRL_INTERRUPT_SLOTS (default 16) interrupt slots.
+        *
+        * @return False when the encoder is multiplexed, a pin has no
+        * interrupt, or the interrupt slots are taken.
+        */
+        bool attachPinInterrupts();
+
+        /**
+        * @brief Go back to reading the pins on every process() call.
+        */
+        void detachPinInterrupts();
+
+        /**
+        * @brief Whether process() has anything to do.
+        *
+        * Always true, unless pin interrupts are attached.
+        */
+        [[nodiscard]] bool needsProcessing() const override;
+
+        /**
+        * @brief Call the callbacks of an event held back by a two-phase pass.
+        */
+        void fireEvent(CtrlEvent::Type type, int32_t value) override;
+
+        ~CtrlEnc() override;
+
         /**
         * @brief Find out if an encoder is currently turning left.
         *
@@ -144,10 +188,18 @@ class CtrlEnc : public CtrlBase, public Muxable, public Groupable
     protected:
         void initialize();
         [[nodiscard]] bool isInitialized() const;
+        [[nodiscard]] uint8_t getMuxChannel() const override;
+        [[nodiscard]] uint8_t getMuxPinMode() const override;
+        [[nodiscard]] bool getMuxIdleLevel() const override;
+        [[nodiscard]] uint8_t getScanPriority() const override;
+        [[nodiscard]] bool isScanIdle(unsigned long now, unsigned long timeout) const override;
+        [[nodiscard]] uint16_t getMuxChannelMask() const override;
+        void onPinChange() override;
+        void processSteps();
         virtual void processInput();
         virtual int8_t readEncoder();
-        int8_t readEncoderFromIsr(bool clkState, bool dtState);
-        int8_t decodeStep();
+        int8_t readEncoderFromIsr(bool clkState, bool dtState, bool& moved);
+        int8_t decodeStep(bool& moved);
         virtual void onTurnLeft();
         virtual void onTurnRight();
 };
@@ -0,0 +1,84 @@
+/*!
+ *  @file       CtrlEventQueue.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CtrlEventQueue.h"
+
+CtrlEventQueue::CtrlEventQueue(CtrlEvent* storage, const uint8_t capacity)
+    : storage(storage), mask(static_cast<uint8_t>(capacity - 1))
+{
+}
+
+bool CtrlEventQueue::push(const CtrlEvent& event)
+{
+    const uint8_t position = this->head;
+    if (static_cast<uint8_t>(position - this->tail) > this->mask) {
+        this->dropped = this->dropped + 1;
+        return false;
+    }
+    this->storage[position & this->mask] = event;
+    // The event must be stored before the consumer can see it.
+    CTRL_MEMORY_BARRIER();
+    this->head = static_cast<uint8_t>(position + 1);
+    return true;
+}
+
+bool CtrlEventQueue::pop(CtrlEvent& event)
+{
+    const uint8_t position = this->tail;
+    if (position == this->head) return false;
+    CTRL_MEMORY_BARRIER();
+    event = this->storage[position & this->mask];
+    // The event must be read before the producer can overwrite it.
+    CTRL_MEMORY_BARRIER();
+    this->tail = static_cast<uint8_t>(position + 1);
+    return true;
+}
+
+uint8_t CtrlEventQueue::available() const
+{
+    return static_cast<uint8_t>(this->head - this->tail);
+}
+
+bool CtrlEventQueue::isEmpty() const
+{
+    return this->head == this->tail;
+}
+
+uint8_t CtrlEventQueue::getCapacity() const
+{
+    return static_cast<uint8_t>(this->mask + 1);
+}
+
+uint16_t CtrlEventQueue::getDropped() const
+{
+    return this->dropped;
+}
+
+void CtrlEventQueue::clear()
+{
+    this->tail = this->head;
+}
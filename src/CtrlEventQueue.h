@@ -0,0 +1,148 @@
+/*!
+ *  @file       CtrlEventQueue.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLEVENTQUEUE_H
+#define CTRLEVENTQUEUE_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_AVR)
+    // Single core, no reordering by the hardware: only keep the compiler from reordering.
+    #define CTRL_MEMORY_BARRIER() __asm__ volatile ("" ::: "memory")
+#else
+    #define CTRL_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+/*
+ * An event of a control, as stored in a CtrlEventQueue.
+ */
+struct CtrlEvent
+{
+    enum Type : uint8_t {
+        PRESS,
+        RELEASE,
+        DELAYED_RELEASE,
+        TURN_LEFT,
+        TURN_RIGHT,
+        VALUE_CHANGE,
+        CLICK,
+        LONG_PRESS,
+        REPEAT,
+        CHORD
+    };
+
+    uint8_t source = 0; // The id given to the control with CtrlBase::setEventQueue().
+    Type type = PRESS;
+    int32_t value = 0; // The value of a VALUE_CHANGE, the clicks of a CLICK, the button of a CtrlBtnBank, the mask of a CHORD, 0 otherwise.
+    uint32_t time = 0; // CtrlClock::now() of the event.
+};
+
+/*
+ * A lock-free ring buffer of events, for one producer and one consumer.
+ *
+ * Controls with a queue (see CtrlBase::setEventQueue()) push their events
+ * instead of calling their callbacks, so process() never waits on a slow
+ * callback. The application pops the events when it has time.
+ *
+ * The producer and the consumer may run in different contexts, e.g. a timer
+ * interrupt pushing and the loop popping, but each side must only run in one
+ * context at a time. When the queue is full, new events are dropped (and counted).
+ */
+class CtrlEventQueue
+{
+    protected:
+        CtrlEvent* storage;
+        uint8_t mask; // Capacity - 1, the capacity is a power of two.
+        volatile uint8_t head = 0; // Free running, only written by the producer.
+        volatile uint8_t tail = 0; // Free running, only written by the consumer.
+        volatile uint16_t dropped = 0; // Only written by the producer.
+
+        /**
+        * @brief Instantiate a queue on fixed storage, see CtrlEventQueueT.
+        *
+        * @param storage The events, never reallocated nor deleted.
+        * @param capacity The number of events, a power of two up to 128.
+        */
+        CtrlEventQueue(CtrlEvent* storage, uint8_t capacity);
+
+    public:
+        CtrlEventQueue(const CtrlEventQueue&) = delete;
+        CtrlEventQueue& operator=(const CtrlEventQueue&) = delete;
+
+        /**
+        * @brief Add an event (producer side).
+        *
+        * @return false when the queue is full, the event is then dropped.
+        */
+        bool push(const CtrlEvent& event);
+
+        /**
+        * @brief Take the oldest event (consumer side).
+        *
+        * @return false when the queue is empty.
+        */
+        bool pop(CtrlEvent& event);
+
+        /**
+        * @brief The number of events waiting.
+        */
+        [[nodiscard]] uint8_t available() const;
+
+        [[nodiscard]] bool isEmpty() const;
+
+        [[nodiscard]] uint8_t getCapacity() const;
+
+        /**
+        * @brief The number of events dropped because the queue was full.
+        */
+        [[nodiscard]] uint16_t getDropped() const;
+
+        /**
+        * @brief Drop all waiting events (consumer side).
+        */
+        void clear();
+};
+
+/*
+ * An event queue with room for Capacity events (a power of two up to 128).
+ */
+template <uint8_t Capacity>
+class CtrlEventQueueT : public CtrlEventQueue
+{
+    static_assert(Capacity >= 2 && Capacity <= 128 && (Capacity & (Capacity - 1)) == 0,
+        "CtrlEventQueueT needs a power of two capacity, from 2 up to 128.");
+
+    protected:
+        CtrlEvent events[Capacity] = {};
+
+    public:
+        CtrlEventQueueT() : CtrlEventQueue(this->events, Capacity)
+        {
+        }
+};
+
+#endif // CTRLEVENTQUEUE_H
@@ -0,0 +1,171 @@
+/*!
+ *  @file       CtrlExpander.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "CtrlExpander.h"
+#include "CtrlClock.h"
+#include "Muxable.h"
+
+CtrlExpander::CtrlExpander(const uint8_t intPin) : intPin(intPin)
+{
+}
+
+bool CtrlExpander::initialize()
+{
+    if (this->initialized) return true;
+    if (!this->writeConfig(IOCON_MIRROR | IOCON_SEQOP)) return false;
+    if (this->intPin != UINT8_MAX) {
+        this->interruptPin.attach(this->intPin);
+        this->interruptPin.setMode(INPUT_PULLUP);
+    }
+    this->initialized = true;
+    return true;
+}
+
+void CtrlExpander::refreshScanPlan()
+{
+    uint16_t pullUps = 0;
+    uint16_t used = 0;
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        const uint16_t mask = this->objects[i]->getMuxChannelMask();
+        used |= mask;
+        if (this->objects[i]->getMuxPinMode() == INPUT_PULLUP) pullUps |= mask;
+    }
+
+    if (pullUps != this->pullUps && this->writeRegisters(REG_GPPUA, pullUps)) {
+        this->pullUps = pullUps;
+        this->captured = false; // Inputs read before their pull-up was enabled.
+    }
+    const uint16_t interrupts = this->intPin != UINT8_MAX ? used : 0;
+    if (interrupts != this->interrupts && this->writeRegisters(REG_GPINTENA, interrupts)) {
+        this->interrupts = interrupts;
+        this->captured = false; // Changes of newly enabled pins were not flagged.
+    }
+    // Retry a failed write on the next pass.
+    if (pullUps != this->pullUps || interrupts != this->interrupts) this->scanPlanStale = true;
+}
+
+void CtrlExpander::capture()
+{
+    if (!this->initialize()) {
+        this->captured = false;
+        this->seedInputs();
+        return;
+    }
+    this->updateScanPlan();
+    uint16_t value;
+    if (this->readGpio(value)) {
+        this->inputs = value;
+        this->captured = true;
+        this->acknowledged = true;
+    } else {
+        this->captured = false; // Retry on the next pass.
+        this->seedInputs();
+    }
+}
+
+void CtrlExpander::seedInputs()
+{
+    if (this->acknowledged) return;
+    uint16_t inputs = 0;
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        if (this->objects[i]->getMuxIdleLevel()) inputs |= this->objects[i]->getMuxChannelMask();
+    }
+    this->inputs = inputs;
+}
+
+void CtrlExpander::update()
+{
+    if (!this->initialize()) {
+        this->captured = false;
+        this->seedInputs();
+        return;
+    }
+    this->updateScanPlan();
+    // INT is active low, and cleared by reading GPIO.
+    if (this->captured && this->intPin != UINT8_MAX && this->interruptPin.read()) return;
+    this->capture();
+}
+
+void CtrlExpander::refresh()
+{
+    const uint16_t pass = CtrlClock::getPass();
+    if (pass != 0 && pass == this->capturedPass) return;
+    this->update();
+    this->capturedPass = pass;
+}
+
+void CtrlExpander::beginPass()
+{
+    this->update();
+    this->inPass = true;
+}
+
+void CtrlExpander::endPass()
+{
+    this->inPass = false;
+}
+
+bool CtrlExpander::readInput(const uint8_t pin)
+{
+    if (pin >= PIN_COUNT) return false;
+    if (!this->inPass) this->refresh();
+    return bitRead(this->inputs, pin);
+}
+
+uint16_t CtrlExpander::getInputs() const
+{
+    return this->inputs;
+}
+
+bool CtrlExpander::readBtnSig(const uint8_t channel, uint8_t)
+{
+    return this->readInput(channel);
+}
+
+bool CtrlExpander::readEncClk(const uint8_t channel, uint8_t)
+{
+    return this->readInput(channel);
+}
+
+bool CtrlExpander::readEncDt(const uint8_t channel, uint8_t)
+{
+    return this->readInput(channel);
+}
+
+uint32_t CtrlExpander::readBtnBits(const uint8_t channel, const uint8_t count, uint8_t)
+{
+    if (channel >= PIN_COUNT || count == 0) return 0;
+    if (!this->inPass) this->refresh();
+    const uint32_t levels = static_cast<uint32_t>(this->inputs) >> channel;
+    return count >= 32 ? levels : levels & ((1ul << count) - 1);
+}
+
+uint16_t CtrlExpander::readPotSig(uint8_t, uint8_t)
+{
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*!
+ *  @file       CtrlExpander.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef CTRLEXPANDER_H
+#define CTRLEXPANDER_H
+
+#include <Arduino.h>
+#include "CtrlPinIO.h"
+#include "CtrlSource.h"
+
+/*
+ * Base class of the 16 bit MCP23x17 GPIO expanders: CtrlMCP23017 (I2C) and
+ * CtrlMCP23S17 (SPI).
+ *
+ * Buttons and rotary encoders read their inputs from the expander the same
+ * way they would from a multiplexer, with the pin number as channel: 0 - 7 are
+ * GPA0 - GPA7, 8 - 15 are GPB0 - GPB7. Both GPIO registers are read in a
+ * single bus transaction at the start of every process() pass, and all objects
+ * decode from that capture.
+ *
+ * When the INT pin of the expander is connected, the read is skipped as long
+ * as no input changed since the previous one.
+ */
+class CtrlExpander : public CtrlSource
+{
+    public:
+        static constexpr uint8_t PIN_COUNT = 16;
+
+    protected:
+        // Registers, in the (power-on default) IOCON.BANK = 0 layout.
+        static constexpr uint8_t REG_GPINTENA = 0x04;
+        static constexpr uint8_t REG_IOCON = 0x0A;
+        static constexpr uint8_t REG_GPPUA = 0x0C;
+        static constexpr uint8_t REG_GPIOA = 0x12;
+
+        static constexpr uint8_t IOCON_MIRROR = 0x40; // One INT pin for both ports.
+        static constexpr uint8_t IOCON_SEQOP = 0x20; // Byte mode: the address pointer toggles between A/B pairs.
+        static constexpr uint8_t IOCON_HAEN = 0x08; // Hardware address enable (MCP23S17).
+
+        uint8_t intPin;
+        CtrlPin interruptPin;
+        uint16_t inputs = 0;
+        uint16_t pullUps = 0; // Written to GPPUA/B.
+        uint16_t interrupts = 0; // Written to GPINTENA/B.
+        bool captured = false;
+        bool acknowledged = false; // A capture succeeded: until then, the inputs are the objects' idle levels.
+        bool inPass = false;
+        uint16_t capturedPass = 0; // The CtrlClock pass of the last update outside beginPass().
+        bool initialized = false;
+
+        explicit CtrlExpander(uint8_t intPin);
+
+        /**
+        * @brief Configure the expander, retried on every read until it acknowledges.
+        *
+        * @return false when the expander is not configured yet.
+        */
+        bool initialize();
+
+        void beginPass() override;
+
+        void endPass() override;
+
+        /**
+        * @brief Enable the pull-ups & interrupts of the pins read by the objects.
+        */
+        void refreshScanPlan() override;
+
+        /**
+        * @brief Capture the inputs, unless the INT pin tells nothing changed.
+        */
+        void update();
+
+        /**
+        * @brief Set the inputs to the idle levels of the objects, until the first capture.
+        *
+        * Objects then initialize as released, instead of from zeroed inputs.
+        */
+        void seedInputs();
+
+        /**
+        * @brief Update the inputs for a read outside process(), once per CtrlClock pass.
+        */
+        void refresh();
+
+        bool readInput(uint8_t pin);
+
+        /**
+        * @brief Write the IOCON register, with the bits needed by the bus added.
+        *
+        * @return false when the transaction failed.
+        */
+        virtual bool writeConfig(uint8_t iocon) = 0;
+
+        /**
+        * @brief Write the A and B register of a pair in one transaction.
+        */
+        virtual bool writeRegisters(uint8_t reg, uint16_t value) = 0;
+
+        /**
+        * @brief Read GPIOA and GPIOB in one transaction.
+        *
+        * @return false when the transaction failed.
+        */
+        virtual bool readGpio(uint16_t& value) = 0;
+
+    public:
+        /**
+        * @brief Read both GPIO registers.
+        *
+        * Called at the start of every process() pass. Objects that are
+        * processed elsewhere (e.g. in a CtrlGroup) read the expander once per
+        * pass of the group, or on each read when processed on their own,
+        * unless the INT pin tells nothing changed.
+        */
+        void capture();
+
+        /**
+        * @brief The captured inputs.
+        *
+        * @return The inputs (bits 0 - 7 are GPA0 - GPA7, 8 - 15 are GPB0 - GPB7).
+        */
+        [[nodiscard]] uint16_t getInputs() const;
+
+        [[nodiscard]] bool readBtnSig(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] bool readEncClk(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] bool readEncDt(uint8_t channel, uint8_t pinModeType) override;
+
+        /**
+        * @brief The expanders are digital only: potentiometers always read 0.
+        */
+        [[nodiscard]] uint16_t readPotSig(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] uint32_t readBtnBits(uint8_t channel, uint8_t count, uint8_t pinModeType) override;
+};
+
+#endif // CTRLEXPANDER_H
@@ -34,8 +34,12 @@ CtrlGroup::~CtrlGroup() {
     for (size_t i = 0; i < this->objectCount; ++i) {
         this->objects[i]->group = nullptr;
         this->objects[i]->grouped = false;
+        this->objects[i]->groupIndex = SIZE_MAX;
+        this->objects[i]->groupBit = Groupable::NO_GROUP_BIT;
     }
     delete[] this->objects;
+    delete[] this->chords;
+    delete this->deferredEvents;
 }
 
 void CtrlGroup::enable() { this->enabled = true; }
@@ -47,34 +51,71 @@ bool CtrlGroup::isEnabled() const { return this->enabled; }
 bool CtrlGroup::isDisabled() const { return !this->enabled; }
 
 bool CtrlGroup::addObject(Groupable* object) {
-    for (size_t i = 0; i < this->objectCount; ++i) {
-        if (this->objects[i] == object) return true;
-    }
+    if (this->contains(object)) return true;
     if (this->objectCount == this->capacity) {
         resize();
         if (this->objectCount == this->capacity) return false;
     }
+    object->groupIndex = this->objectCount;
     this->objects[this->objectCount++] = object;
+    for (uint8_t bit = 0; bit < 32; ++bit) {
+        if ((this->groupBits & (1UL << bit)) == 0) {
+            this->groupBits |= 1UL << bit;
+            object->groupBit = bit;
+            break;
+        }
+    }
+    if (object->getScanPriority() == CtrlBase::PRIORITY_HIGH) this->orderDirty = true;
     object->group = this;
     object->grouped = true;
     return true;
 }
 
 void CtrlGroup::removeObject(Groupable* object) {
+    if (!this->contains(object)) return;
+    const size_t i = object->groupIndex;
+    if (i < this->highCount) this->orderDirty = true;
+    object->group = nullptr;
+    object->grouped = false;
+    object->groupIndex = SIZE_MAX;
+    if (object->groupBit != Groupable::NO_GROUP_BIT) {
+        this->groupBits &= ~(1UL << object->groupBit);
+        this->pressedMask &= ~(1UL << object->groupBit);
+        this->windowMask &= ~(1UL << object->groupBit);
+        object->groupBit = Groupable::NO_GROUP_BIT;
+    }
+    const size_t last = --this->objectCount;
+    // Swap-remove. Objects before nextIndex were already processed this round,
+    // so the gap is filled such that the ones still waiting stay at or after it.
+    if (i < this->cursor.nextIndex) {
+        this->moveObject(this->cursor.nextIndex - 1, i);
+        this->moveObject(last, this->cursor.nextIndex - 1);
+        --this->cursor.nextIndex;
+    } else {
+        this->moveObject(last, i);
+    }
+    if (this->cursor.nextIndex >= this->objectCount) {
+        this->cursor.nextIndex = this->highCount < this->objectCount ? this->highCount : 0;
+    }
+}
+
+bool CtrlGroup::contains(const Groupable* object) const {
+    return object->groupIndex < this->objectCount && this->objects[object->groupIndex] == object;
+}
+
+void CtrlGroup::updateOrder() {
+    this->highCount = ctrlPartitionByPriority(this->objects, this->objectCount);
     for (size_t i = 0; i < this->objectCount; ++i) {
-        if (this->objects[i] == object) {
-            object->group = nullptr;
-            object->grouped = false;
-            for (size_t j = i; j < this->objectCount - 1; ++j) {
-                this->objects[j] = this->objects[j + 1];
-            }
-            --this->objectCount;
-            if (this->objectCount == 0 || this->nextIndex >= this->objectCount) {
-                this->nextIndex = 0;
-            }
-            return;
-        }
+        this->objects[i]->groupIndex = i;
     }
+    this->priorityVersion = CtrlBase::priorityVersion;
+    this->orderDirty = false;
+}
+
+void CtrlGroup::moveObject(const size_t from, const size_t to) {
+    if (from == to) return;
+    this->objects[to] = this->objects[from];
+    this->objects[to]->groupIndex = to;
 }
 
 void CtrlGroup::reserve(const size_t capacity) {
@@ -92,18 +133,71 @@ void CtrlGroup::reserve(const size_t capacity) {
 void CtrlGroup::process(const uint8_t count)
 {
     if (!this->enabled || this->objectCount == 0) return;
-    if (count == 0) {
-        for (size_t i = 0; i < this->objectCount; ++i) {
-            this->objects[i]->process();
-        }
-    } else {
-        const uint8_t n = count > this->objectCount ? static_cast<uint8_t>(this->objectCount) : count;
-        for (uint8_t i = 0; i < n; ++i) {
-            this->objects[this->nextIndex]->process();
-            if (this->objectCount == 0) return;
-            this->nextIndex = (this->nextIndex + 1) % this->objectCount;
-        }
+    const CtrlClock::Pass pass; // All objects of the pass share one timestamp.
+    const CtrlDeferredEvents::Phase phase(this->deferredEvents); // Fires the held back events on return.
+    if (this->priorityVersion != CtrlBase::priorityVersion) this->orderDirty = true;
+    if (this->orderDirty) this->updateOrder();
+    // A full pass does not move the round-robin position.
+    CtrlSliceCursor fullPass;
+    CtrlSliceCursor& cursor = count == 0 ? fullPass : this->cursor;
+    CtrlSlice<Groupable> slice(count, this->objectCount, this->highCount);
+    slice.setIdleScan(this->idleScan);
+    slice.setDirtyScan();
+    while (Groupable* object = slice.next(this->objects, this->objectCount, this->highCount, cursor)) {
+        object->process();
+        if (this->objectCount == 0) return;
+    }
+}
+
+size_t CtrlGroup::processFor(const uint32_t budget)
+{
+    if (!this->enabled || this->objectCount == 0) return 0;
+    const CtrlClock::Pass pass; // All objects of the pass share one timestamp.
+    const CtrlDeferredEvents::Phase phase(this->deferredEvents); // Fires the held back events on return.
+    if (this->priorityVersion != CtrlBase::priorityVersion) this->orderDirty = true;
+    if (this->orderDirty) this->updateOrder();
+    const uint32_t start = CtrlClock::nowMicros();
+    CtrlSlice<Groupable> slice(this->objectCount, this->objectCount, this->highCount);
+    slice.setIdleScan(this->idleScan);
+    slice.setDirtyScan();
+    size_t processed = 0;
+    while (Groupable* object = slice.peek(this->objects, this->objectCount, this->highCount, this->cursor)) {
+        if (processed > 0 && static_cast<uint32_t>(CtrlClock::nowMicros() - start) + object->groupCost > budget) break;
+        slice.next(this->objects, this->objectCount, this->highCount, this->cursor);
+        const uint32_t before = CtrlClock::nowMicros();
+        object->process();
+        ctrlUpdateCost(object->groupCost, CtrlClock::nowMicros() - before);
+        ++processed;
+        if (this->objectCount == 0) break;
     }
+    return processed;
+}
+
+size_t CtrlGroup::processForPeriod(const uint32_t period)
+{
+    return this->processFor(this->loopTuner.update(period, CtrlClock::nowMicros()));
+}
+
+void CtrlGroup::setIdleScan(const unsigned long timeout, const uint8_t interval)
+{
+    this->idleScan.timeout = timeout;
+    this->idleScan.interval = interval;
+}
+
+bool CtrlGroup::setTwoPhaseScan(const bool enabled, const uint8_t capacity)
+{
+    // Not from a callback of a two-phase pass: its events are still in use.
+    if (this->deferredEvents != nullptr && this->deferredEvents->isInUse()) return false;
+    delete this->deferredEvents;
+    this->deferredEvents = nullptr;
+    if (!enabled) return true;
+    auto* events = new (std::nothrow) CtrlDeferredEvents(capacity);
+    if (events == nullptr || events->getCapacity() == 0) {
+        delete events;
+        return false;
+    }
+    this->deferredEvents = events;
+    return true;
 }
 
 void CtrlGroup::setOnPress(void (*callback)(Groupable&))
@@ -121,6 +215,21 @@ void CtrlGroup::setOnDelayedRelease(void (*callback)(Groupable&))
     this->onDelayedReleaseCallback = callback;
 }
 
+void CtrlGroup::setOnClick(void (*callback)(Groupable&, uint8_t clicks))
+{
+    this->onClickCallback = callback;
+}
+
+void CtrlGroup::setOnLongPress(void (*callback)(Groupable&))
+{
+    this->onLongPressCallback = callback;
+}
+
+void CtrlGroup::setOnRepeat(void (*callback)(Groupable&))
+{
+    this->onRepeatCallback = callback;
+}
+
 void CtrlGroup::setOnTurnLeft(void (*callback)(Groupable&))
 {
     this->onTurnLeftCallback = callback;
@@ -136,6 +245,115 @@ void CtrlGroup::setOnValueChange(void (*callback)(Groupable&, int value))
     this->onValueChangeCallback = callback;
 }
 
+uint32_t CtrlGroup::getMask(const Groupable& object) const
+{
+    if (object.group != this || object.groupBit == Groupable::NO_GROUP_BIT) return 0;
+    return 1UL << object.groupBit;
+}
+
+uint32_t CtrlGroup::getPressedMask() const
+{
+    return this->pressedMask;
+}
+
+bool CtrlGroup::addChord(const uint32_t mask)
+{
+    if (mask == 0) return false;
+    if (this->hasChord(mask)) return true;
+    // Keep the table at most half full, probes then stay short.
+    if ((this->chordCount + 1) * 2 > this->chordCapacity && !this->resizeChords()) return false;
+    this->insertChord(mask);
+    return true;
+}
+
+void CtrlGroup::clearChords()
+{
+    for (uint8_t i = 0; i < this->chordCapacity; ++i) {
+        this->chords[i] = 0;
+    }
+    this->chordCount = 0;
+}
+
+void CtrlGroup::setChordWindow(const uint16_t window)
+{
+    this->chordWindow = window;
+}
+
+void CtrlGroup::setOnChord(void (*callback)(uint32_t mask))
+{
+    this->onChordCallback = callback;
+}
+
+void CtrlGroup::setPressed(const Groupable& object, const bool pressed)
+{
+    const uint32_t mask = this->getMask(object);
+    if (mask == 0) return;
+    if (!pressed) {
+        this->pressedMask &= ~mask;
+        this->windowMask &= ~mask;
+        return;
+    }
+    const unsigned long now = CtrlClock::now();
+    if (this->pressedMask == 0 || now - this->chordStart > this->chordWindow) {
+        this->chordStart = now;
+        this->windowMask = 0;
+    }
+    this->pressedMask |= mask;
+    this->windowMask |= mask;
+}
+
+uint32_t CtrlGroup::matchChord() const
+{
+    if (this->chordCount == 0) return 0;
+    // Every pressed button must have been pressed within the window.
+    if (this->chordWindow > 0 && this->windowMask != this->pressedMask) return 0;
+    return this->hasChord(this->pressedMask) ? this->pressedMask : 0;
+}
+
+static uint8_t chordSlot(const uint32_t mask, const uint8_t capacity)
+{
+    // Fibonacci hashing: the multiplication mixes all bits into the high half.
+    const uint32_t hash = static_cast<uint32_t>(mask * 2654435769UL);
+    return static_cast<uint8_t>((hash >> 16) & (capacity - 1));
+}
+
+bool CtrlGroup::hasChord(const uint32_t mask) const
+{
+    if (this->chordCount == 0 || mask == 0) return false;
+    for (uint8_t i = chordSlot(mask, this->chordCapacity); this->chords[i] != 0; i = (i + 1) & (this->chordCapacity - 1)) {
+        if (this->chords[i] == mask) return true;
+    }
+    return false;
+}
+
+void CtrlGroup::insertChord(const uint32_t mask)
+{
+    uint8_t i = chordSlot(mask, this->chordCapacity);
+    while (this->chords[i] != 0) {
+        i = (i + 1) & (this->chordCapacity - 1);
+    }
+    this->chords[i] = mask;
+    ++this->chordCount;
+}
+
+bool CtrlGroup::resizeChords()
+{
+    const uint16_t newCapacity = this->chordCapacity == 0 ? CTRL_GROUP_CHORD_SLOTS : this->chordCapacity * 2;
+    if (newCapacity > 128 || (newCapacity & (newCapacity - 1)) != 0) return false;
+    auto* newChords = new (std::nothrow) uint32_t[newCapacity]();
+    if (newChords == nullptr) return false;
+    uint32_t* oldChords = this->chords;
+    const uint8_t oldCapacity = this->chordCapacity;
+    this->chords = newChords;
+    this->chordCapacity = static_cast<uint8_t>(newCapacity);
+    this->chordCount = 0;
+    for (uint8_t i = 0; i < oldCapacity; ++i) {
+        if (oldChords[i] != 0) this->insertChord(oldChords[i]);
+    }
+    delete[] oldChords;
+    return true;
+}
+
 void CtrlGroup::resize() {
     const size_t newCapacity = this->capacity == 0 ? 4 : this->capacity * 2;
     if (newCapacity <= this->capacity) return;
@@ -28,8 +28,13 @@
 #ifndef CTRLGROUP_H
 #define CTRLGROUP_H
 
+#include "CtrlSlice.h"
 #include "Groupable.h"
 
+#ifndef CTRL_GROUP_CHORD_SLOTS
+    #define CTRL_GROUP_CHORD_SLOTS 8 // The initial size of the chord table of a group.
+#endif
+
 class CtrlBtn;
 class CtrlEnc;
 class CtrlPot;
@@ -81,6 +86,14 @@ class CtrlGroup final
         */
         bool addObject(Groupable* object);
 
+        /**
+        * @brief Remove an object from the group.
+        *
+        * Adding and removing objects takes constant time: objects know their
+        * slot, and the last object fills the gap of a removed one.
+        *
+        * @param object Object to be removed from the group.
+        */
         void removeObject(Groupable* object);
 
         /**
@@ -100,9 +113,56 @@ class CtrlGroup final
         * When 0 (default), all objects are processed. When > 0, objects are
         * processed in round-robin order for time-sliced control processing
         * in audio applications.
+        *
+        * With count > 0, objects with CtrlBase::PRIORITY_HIGH (e.g. encoders)
+        * are serviced on every call, the remaining slots go round-robin to the
+        * others, where PRIORITY_LOW objects (e.g. potentiometers) only get a turn
+        * every CtrlBase::LOW_PRIORITY_INTERVAL rounds. Never more than count
+        * objects are processed per call. See CtrlMux::process().
         */
         void process(uint8_t count = 0);
 
+        /**
+        * @brief Process objects in round-robin order within a time budget.
+        *
+        * A running estimate of the time each object takes to process is kept.
+        * Objects are processed (in the same order, and with the same priorities
+        * as process(count)) until the next one would exceed the budget. At least
+        * one object, and every object at most once, is processed per call.
+        *
+        * @param budget (uint32_t) The time budget in microseconds.
+        * @return The number of objects processed.
+        */
+        size_t processFor(uint32_t budget);
+
+        /**
+        * @brief Process objects within a budget that is tuned to hold a loop period.
+        * See CtrlMux::processForPeriod().
+        *
+        * @param period (uint32_t) The target loop period in microseconds.
+        * @return The number of objects processed.
+        */
+        size_t processForPeriod(uint32_t period);
+
+        /**
+        * @brief Scan objects that are not being touched at a lower rate.
+        * See CtrlMux::setIdleScan().
+        *
+        * @param timeout (unsigned long) Milliseconds without input change before an object is idle, 0 to disable.
+        * @param interval (uint8_t) (optional) Idle objects are processed on 1 out of interval turns. Default is 8.
+        */
+        void setIdleScan(unsigned long timeout, uint8_t interval = 8);
+
+        /**
+        * @brief Sample all objects first, then fire their events.
+        * See CtrlMux::setTwoPhaseScan().
+        *
+        * @param enabled (bool) Enable or disable the two-phase scan.
+        * @param capacity (uint8_t) (optional) The number of events held back per pass, more fire right away. Default is 16.
+        * @return false when there is no memory for the events.
+        */
+        bool setTwoPhaseScan(bool enabled, uint8_t capacity = 16);
+
         /**
         * @brief Set the on press handler (for buttons).
         *
@@ -132,6 +192,37 @@ class CtrlGroup final
         */
         void setOnDelayedRelease(void (*callback)(Groupable&));
 
+        /**
+        * @brief Set the on click handler (for buttons).
+        *
+        * Pass in a handler that is called with the number of clicks (1, 2 or 3)
+        * whenever a button in the group completes a single, double or triple click.
+        * See CtrlBtn::setOnClick().
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnClick(void (*callback)(Groupable&, uint8_t clicks));
+
+        /**
+        * @brief Set the on long press handler (for buttons).
+        *
+        * Pass in a handler that is called once whenever a button in the group is held
+        * for its long press duration. See CtrlBtn::setOnLongPress().
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnLongPress(void (*callback)(Groupable&));
+
+        /**
+        * @brief Set the on repeat handler (for buttons).
+        *
+        * Pass in a handler that is called repeatedly while a button in the group is held.
+        * See CtrlBtn::setOnRepeat().
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnRepeat(void (*callback)(Groupable&));
+
         /**
         * @brief Set the on turn left handler (for rotary encoders).
         *
@@ -159,19 +250,105 @@ class CtrlGroup final
         */
         void setOnValueChange(void (*callback)(Groupable&, int value));
 
+        /**
+        * @brief Get the bit of an object in the masks of the group.
+        *
+        * The first 32 objects added to the group each get a bit, which they
+        * keep until they are removed from the group.
+        *
+        * @param object The object.
+        * @return The mask with the bit of the object, 0 if it has none.
+        */
+        [[nodiscard]] uint32_t getMask(const Groupable& object) const;
+
+        /**
+        * @brief Get the buttons of the group that are currently pressed.
+        *
+        * @return The mask of the pressed buttons, see getMask().
+        */
+        [[nodiscard]] uint32_t getPressedMask() const;
+
+        /**
+        * @brief Register a combination of buttons that are pressed together.
+        *
+        * The chord fires when the pressed buttons of the group are exactly the
+        * buttons of the chord, and all of them were pressed within the chord
+        * window. Chords are kept in a hash table, so matching a press takes
+        * the same time however many chords there are.
+        *
+        * @param mask The buttons of the chord, e.g. group.getMask(a) | group.getMask(b).
+        * @return False when there is no memory for the chord.
+        */
+        bool addChord(uint32_t mask);
+
+        /**
+        * @brief Remove all chords.
+        */
+        void clearChords();
+
+        /**
+        * @brief Set the time in which all buttons of a chord must be pressed.
+        *
+        * The window starts at the first press after all buttons were released,
+        * or after the last window passed.
+        *
+        * @param window The window in milliseconds, 0 for no limit (default is 50ms).
+        */
+        void setChordWindow(uint16_t window);
+
+        /**
+        * @brief Set the on chord handler.
+        *
+        * Pass in a handler that is called with the mask of the chord whenever
+        * a registered chord is pressed. The press callbacks of the buttons are
+        * called as usual, before the chord. The chord is an event of the button
+        * that completed it: with an event queue it is pushed as a CHORD event
+        * (value is the mask) after the press, and a two-phase scan holds it
+        * back with the other events.
+        *
+        * @param callback The callback handler method.
+        */
+        void setOnChord(void (*callback)(uint32_t mask));
+
     private:
         bool enabled = true;
         Groupable** objects = nullptr;
         size_t objectCount = 0;
         size_t capacity = 0;
-        size_t nextIndex = 0;
+        CtrlSliceCursor cursor;
+        size_t highCount = 0; // The high priority objects come first.
+        uint16_t priorityVersion = 0;
+        CtrlLoopTuner loopTuner;
+        CtrlIdleScan idleScan;
+        CtrlDeferredEvents* deferredEvents = nullptr; // Only with a two-phase scan.
+        uint32_t groupBits = 0; // The bits given to objects.
+        uint32_t pressedMask = 0;
+        uint32_t* chords = nullptr; // Open addressing hash table of chord masks, 0 is an empty slot.
+        uint8_t chordCount = 0;
+        uint8_t chordCapacity = 0; // A power of 2.
+        uint16_t chordWindow = 50; // In milliseconds.
+        unsigned long chordStart = 0;
+        uint32_t windowMask = 0; // The buttons pressed since chordStart.
+        bool orderDirty = false;
         void (*onPressCallback)(Groupable&) = nullptr;
         void (*onReleaseCallback)(Groupable&) = nullptr;
         void (*onDelayedReleaseCallback)(Groupable&) = nullptr;
+        void (*onClickCallback)(Groupable&, uint8_t clicks) = nullptr;
+        void (*onLongPressCallback)(Groupable&) = nullptr;
+        void (*onRepeatCallback)(Groupable&) = nullptr;
         void (*onTurnLeftCallback)(Groupable&) = nullptr;
         void (*onTurnRightCallback)(Groupable&) = nullptr;
         void (*onValueChangeCallback)(Groupable&, int value) = nullptr;
+        void (*onChordCallback)(uint32_t mask) = nullptr;
         void resize();
+        void setPressed(const Groupable& object, bool pressed);
+        [[nodiscard]] uint32_t matchChord() const;
+        [[nodiscard]] bool hasChord(uint32_t mask) const;
+        void insertChord(uint32_t mask);
+        bool resizeChords();
+        bool contains(const Groupable* object) const;
+        void updateOrder();
+        void moveObject(size_t from, size_t to);
 };
 
 #endif // CTRLGROUP_H
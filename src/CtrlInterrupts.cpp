@@ -0,0 +1,93 @@
+/*!
+ *  @file       CtrlInterrupts.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "CtrlInterrupts.h"
+
+CtrlPinChangeHandler* volatile CtrlInterrupts::handlers[SLOTS] = {};
+uint8_t CtrlInterrupts::pins[SLOTS] = {};
+
+namespace {
+    template <uint8_t Slot>
+    struct CtrlTrampoline
+    {
+        static void call() { CtrlInterrupts::dispatch(Slot - 1); }
+
+        static void (*get(const uint8_t slot))()
+        {
+            return slot == Slot - 1 ? &call : CtrlTrampoline<Slot - 1>::get(slot);
+        }
+    };
+
+    template <>
+    struct CtrlTrampoline<0>
+    {
+        static void (*get(uint8_t))() { return nullptr; }
+    };
+}
+
+bool CtrlInterrupts::attach(const uint8_t pin, CtrlPinChangeHandler* handler)
+{
+    const int interrupt = digitalPinToInterrupt(pin);
+    if (handler == nullptr || interrupt == NOT_AN_INTERRUPT) return false;
+    for (uint8_t slot = 0; slot < SLOTS; ++slot) {
+        // One interrupt per pin: a second attachInterrupt would replace the first handler's vector.
+        if (handlers[slot] != nullptr && pins[slot] == pin) return false;
+    }
+    for (uint8_t slot = 0; slot < SLOTS; ++slot) {
+        if (handlers[slot] != nullptr) continue;
+        handlers[slot] = handler;
+        pins[slot] = pin;
+        attachInterrupt(static_cast<uint8_t>(interrupt), CtrlTrampoline<SLOTS>::get(slot), CHANGE);
+        return true;
+    }
+    return false;
+}
+
+void CtrlInterrupts::detach(CtrlPinChangeHandler* handler)
+{
+    for (uint8_t slot = 0; slot < SLOTS; ++slot) {
+        if (handlers[slot] != handler) continue;
+        detachInterrupt(static_cast<uint8_t>(digitalPinToInterrupt(pins[slot])));
+        handlers[slot] = nullptr;
+    }
+}
+
+uint8_t CtrlInterrupts::getFreeSlots()
+{
+    uint8_t free = 0;
+    for (uint8_t slot = 0; slot < SLOTS; ++slot) {
+        if (handlers[slot] == nullptr) ++free;
+    }
+    return free;
+}
+
+void CtrlInterrupts::dispatch(const uint8_t slot)
+{
+    CtrlPinChangeHandler* handler = handlers[slot];
+    if (handler != nullptr) handler->onPinChange();
+}
@@ -0,0 +1,88 @@
+/*!
+ *  @file       CtrlInterrupts.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef CTRLINTERRUPTS_H
+#define CTRLINTERRUPTS_H
+
+#include <Arduino.h>
+
+#ifndef CTRL_INTERRUPT_SLOTS
+    #define CTRL_INTERRUPT_SLOTS 16 // The number of pins that can have a CHANGE interrupt attached.
+#endif
+
+/*
+ * An object that is told about pin changes, see CtrlInterrupts.
+ */
+class CtrlPinChangeHandler
+{
+    public:
+        /**
+        * @brief Called from the interrupt of an attached pin.
+        */
+        virtual void onPinChange() = 0;
+
+    protected:
+        ~CtrlPinChangeHandler() = default;
+};
+
+/*
+ * Installs CHANGE interrupts for objects.
+ *
+ * attachInterrupt() only takes plain functions, so every slot of a static
+ * table has its own trampoline function, which calls the handler of the slot.
+ */
+class CtrlInterrupts
+{
+    public:
+        static constexpr uint8_t SLOTS = CTRL_INTERRUPT_SLOTS;
+
+        /**
+        * @brief Attach a CHANGE interrupt on a pin to a handler.
+        *
+        * @return false when the pin has no interrupt, is already attached, or all slots are taken.
+        */
+        static bool attach(uint8_t pin, CtrlPinChangeHandler* handler);
+
+        /**
+        * @brief Detach the interrupts of all pins of a handler.
+        */
+        static void detach(CtrlPinChangeHandler* handler);
+
+        /**
+        * @brief The number of free slots.
+        */
+        [[nodiscard]] static uint8_t getFreeSlots();
+
+        static void dispatch(uint8_t slot);
+
+    private:
+        static CtrlPinChangeHandler* volatile handlers[SLOTS];
+        static uint8_t pins[SLOTS];
+};
+
+#endif // CTRLINTERRUPTS_H
@@ -0,0 +1,112 @@
+/*!
+ *  @file       CtrlMCP23017.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef CTRLMCP23017_H
+#define CTRLMCP23017_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "CtrlExpander.h"
+
+/*
+ * A MCP23017 I2C GPIO expander.
+ *
+ * Kept header only (and out of CTRL.h), so sketches that do not use it do not
+ * depend on the Wire library. Call Wire.begin() in setup().
+ *
+ * The expander is put in byte mode, where its address pointer toggles between
+ * GPIOA and GPIOB. Once pointed at GPIOA, every capture is a single 2 byte
+ * read, without writing the register address first.
+ */
+class CtrlMCP23017 : public CtrlExpander
+{
+    protected:
+        TwoWire& wire;
+        uint8_t address;
+        bool pointerAtGpio = false;
+
+        bool writeConfig(const uint8_t iocon) override
+        {
+            this->wire.beginTransmission(this->address);
+            this->wire.write(REG_IOCON);
+            this->wire.write(iocon);
+            this->pointerAtGpio = false;
+            return this->wire.endTransmission() == 0;
+        }
+
+        bool writeRegisters(const uint8_t reg, const uint16_t value) override
+        {
+            this->wire.beginTransmission(this->address);
+            this->wire.write(reg);
+            this->wire.write(static_cast<uint8_t>(value & 0xff));
+            this->wire.write(static_cast<uint8_t>(value >> 8));
+            this->pointerAtGpio = false;
+            return this->wire.endTransmission() == 0;
+        }
+
+        bool readGpio(uint16_t& value) override
+        {
+            if (!this->pointerAtGpio) {
+                this->wire.beginTransmission(this->address);
+                this->wire.write(REG_GPIOA);
+                if (this->wire.endTransmission() != 0) return false;
+                this->pointerAtGpio = true;
+            }
+            if (this->wire.requestFrom(this->address, static_cast<uint8_t>(2)) != 2) {
+                while (this->wire.available() > 0) this->wire.read();
+                this->pointerAtGpio = false; // Unknown after a partial read.
+                return false;
+            }
+            const uint8_t portA = this->wire.read();
+            const uint8_t portB = this->wire.read();
+            value = static_cast<uint16_t>(portA | portB << 8);
+            return true;
+        }
+
+    public:
+        /**
+        * @brief Instantiate a MCP23017 expander object.
+        *
+        * @param address (uint8_t) (optional) The I2C address (0x20 - 0x27). Default is 0x20.
+        * @param intPin (uint8_t) (optional) The pin connected to INTA or INTB, to skip reads
+        * when no input changed. Default is UINT8_MAX (not connected).
+        * @param wire (TwoWire) (optional) The I2C bus. Default is Wire.
+        * @return A new instance of the CtrlMCP23017 class.
+        */
+        explicit CtrlMCP23017(
+            const uint8_t address = 0x20,
+            const uint8_t intPin = UINT8_MAX,
+            TwoWire& wire = Wire
+        ) : CtrlExpander(intPin),
+            wire(wire),
+            address(address)
+        {
+        }
+};
+
+#endif // CTRLMCP23017_H
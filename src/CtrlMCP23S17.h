@@ -0,0 +1,141 @@
+/*!
+ *  @file       CtrlMCP23S17.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef CTRLMCP23S17_H
+#define CTRLMCP23S17_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "CtrlExpander.h"
+#include "CtrlPinIO.h"
+
+/*
+ * A MCP23S17 SPI GPIO expander.
+ *
+ * Kept header only (and out of CTRL.h), so sketches that do not use it do not
+ * depend on the SPI library. Call SPI.begin() in setup().
+ *
+ * Up to 8 expanders can share a chip select pin, each with its own hardware
+ * address (A2 - A0).
+ */
+class CtrlMCP23S17 : public CtrlExpander
+{
+    protected:
+        static constexpr uint8_t OPCODE_WRITE = 0x40;
+        static constexpr uint8_t OPCODE_READ = 0x41;
+
+        SPIClass& spi;
+        SPISettings settings;
+        uint8_t cs;
+        uint8_t address;
+        CtrlPin csPin;
+        bool csAttached = false;
+
+        void select()
+        {
+            if (!this->csAttached) {
+                this->csPin.attach(this->cs);
+                this->csPin.setMode(OUTPUT);
+                this->csPin.write(HIGH);
+                this->csAttached = true;
+            }
+            this->spi.beginTransaction(this->settings);
+            this->csPin.write(LOW);
+        }
+
+        void deselect()
+        {
+            this->csPin.write(HIGH);
+            this->spi.endTransaction();
+        }
+
+        uint8_t opcode(const uint8_t rw) const
+        {
+            return static_cast<uint8_t>(rw | (this->address & 0x07) << 1);
+        }
+
+        bool writeConfig(const uint8_t iocon) override
+        {
+            // Until HAEN is set, all expanders on the chip select accept this.
+            this->select();
+            this->spi.transfer(this->opcode(OPCODE_WRITE));
+            this->spi.transfer(REG_IOCON);
+            this->spi.transfer(static_cast<uint8_t>(iocon | IOCON_HAEN));
+            this->deselect();
+            return true;
+        }
+
+        bool writeRegisters(const uint8_t reg, const uint16_t value) override
+        {
+            this->select();
+            this->spi.transfer(this->opcode(OPCODE_WRITE));
+            this->spi.transfer(reg);
+            this->spi.transfer(static_cast<uint8_t>(value & 0xff));
+            this->spi.transfer(static_cast<uint8_t>(value >> 8));
+            this->deselect();
+            return true;
+        }
+
+        bool readGpio(uint16_t& value) override
+        {
+            uint8_t frame[4] = { this->opcode(OPCODE_READ), REG_GPIOA, 0, 0 };
+            this->select();
+            this->spi.transfer(frame, sizeof(frame));
+            this->deselect();
+            value = static_cast<uint16_t>(frame[2] | frame[3] << 8);
+            return true;
+        }
+
+    public:
+        /**
+        * @brief Instantiate a MCP23S17 expander object.
+        *
+        * @param cs (uint8_t) The chip select (CS) pin.
+        * @param address (uint8_t) (optional) The hardware address (0 - 7). Default is 0.
+        * @param intPin (uint8_t) (optional) The pin connected to INTA or INTB, to skip reads
+        * when no input changed. Default is UINT8_MAX (not connected).
+        * @param spi (SPIClass) (optional) The SPI bus. Default is SPI.
+        * @param clock (uint32_t) (optional) The SPI clock in Hz (max 10 MHz). Default is 10 MHz.
+        * @return A new instance of the CtrlMCP23S17 class.
+        */
+        explicit CtrlMCP23S17(
+            const uint8_t cs,
+            const uint8_t address = 0,
+            const uint8_t intPin = UINT8_MAX,
+            SPIClass& spi = SPI,
+            const uint32_t clock = 10000000
+        ) : CtrlExpander(intPin),
+            spi(spi),
+            settings(clock, MSBFIRST, SPI_MODE0),
+            cs(cs),
+            address(address)
+        {
+        }
+};
+
+#endif // CTRLMCP23S17_H
@@ -25,9 +25,10 @@
  * THE SOFTWARE.
  */
 
-#include <new>
 #include "CtrlBase.h"
+#include "CtrlDelay.h"
 #include "CtrlMux.h"
+#include "CtrlMuxBus.h"
 #include "Muxable.h"
 
 CtrlMux::CtrlMux(
@@ -37,121 +38,273 @@ CtrlMux::CtrlMux(
     const uint8_t s2,
     const uint8_t s3
 ) : sig(sig),
-    s0(s0),
-    s1(s1),
-    s2(s2),
-    s3(s3),
-    s3Present(s3 != UINT8_MAX)
+    selectLines(s0, s1, s2, s3)
 {
 }
 
+CtrlMux::CtrlMux(
+    const uint8_t sig,
+    CtrlMuxBus* bus
+) : CtrlMux(
+    sig,
+    bus->selectLines.getPin(0),
+    bus->selectLines.getPin(1),
+    bus->selectLines.getPin(2),
+    bus->selectLines.getPin(3)
+) {
+    bus->addMux(this);
+}
+
+CtrlMux::CtrlMux(
+    const uint8_t sig,
+    const uint8_t s0,
+    const uint8_t s1,
+    const uint8_t s2,
+    const uint8_t s3,
+    Muxable** storage,
+    const size_t capacity
+) : CtrlMux(sig, s0, s1, s2, s3)
+{
+    this->objects = storage;
+    this->capacity = capacity;
+    this->fixedStorage = true;
+}
+
+CtrlMux::CtrlMux(
+    const uint8_t sig,
+    CtrlMuxBus* bus,
+    Muxable** storage,
+    const size_t capacity
+) : CtrlMux(sig, bus)
+{
+    this->objects = storage;
+    this->capacity = capacity;
+    this->fixedStorage = true;
+}
+
 void CtrlMux::initialize()
 {
     if (this->initialized) return;
-    pinMode(this->s0, OUTPUT);
-    pinMode(this->s1, OUTPUT);
-    pinMode(this->s2, OUTPUT);
-    if (this->s3Present) {
-        pinMode(this->s3, OUTPUT);
-    }
+    this->sigPin.attach(this->sig);
+    this->selectLines.begin();
+    CtrlDelay::begin();
     this->initialized = true;
 }
 
 CtrlMux::~CtrlMux() {
-    for (size_t i = 0; i < this->objectCount; ++i) {
-        this->objects[i]->mux = nullptr;
-        this->objects[i]->muxed = false;
+    if (this->bus != nullptr) {
+        this->bus->removeMux(this);
     }
-    delete[] this->objects;
+}
+
+void CtrlMux::beginPass()
+{
+    this->initialize();
+}
+
+void CtrlMux::endPass()
+{
+    this->frameValid = 0;
 }
 
 void CtrlMux::setPinMode(const uint8_t pinModeType)
 {
     if (this->currentPinMode != pinModeType) {
-        pinMode(this->sig, pinModeType);
+        this->sigPin.setMode(pinModeType);
         this->currentPinMode = pinModeType;
     }
 }
 
-void CtrlMux::setChannel(const uint8_t channel) const
+void CtrlMux::setChannel(const uint8_t channel)
 {
-    digitalWrite(this->s0, bitRead(channel, 0));
-    digitalWrite(this->s1, bitRead(channel, 1));
-    digitalWrite(this->s2, bitRead(channel, 2));
-    if (this->s3Present) {
-        digitalWrite(this->s3, bitRead(channel, 3));
+    if (this->bus != nullptr) {
+        this->bus->setChannel(channel);
+        return;
     }
+    this->claimSelectLines();
+    this->selectLines.select(channel);
 }
 
-bool CtrlMux::addObject(Muxable* object) {
-    for (size_t i = 0; i < this->objectCount; ++i) {
-        if (this->objects[i] == object) return true;
+void CtrlMux::claimSelectLines()
+{
+    // Multiplexers may share their select lines (daisy-chained), so the
+    // remembered channel is only trusted if this mux was the last to drive them.
+    static const CtrlMux* lastDriver = nullptr;
+    if (lastDriver != this) {
+        this->selectLines.invalidate();
+        lastDriver = this;
+    }
+}
+
+static uint8_t grayRank(uint8_t channel)
+{
+    // Position of the channel in the Gray-code sequence (inverse Gray code).
+    channel ^= channel >> 1;
+    channel ^= channel >> 2;
+    return channel;
+}
+
+void CtrlMux::buildScanPlan()
+{
+    // Insertion sort: the object count is small and the plan is usually
+    // nearly sorted already, so this stays cheap and allocation free.
+    for (size_t i = 1; i < this->objectCount; ++i) {
+        Muxable* object = this->objects[i];
+        const bool high = object->getScanPriority() == CtrlBase::PRIORITY_HIGH;
+        const uint8_t mode = object->getMuxPinMode();
+        const uint8_t rank = grayRank(object->getMuxChannel());
+        size_t j = i;
+        while (j > 0) {
+            const Muxable* previous = this->objects[j - 1];
+            const bool previousHigh = previous->getScanPriority() == CtrlBase::PRIORITY_HIGH;
+            if (previousHigh != high) {
+                if (previousHigh) break;
+                this->objects[j] = this->objects[j - 1];
+                --j;
+                continue;
+            }
+            const uint8_t previousMode = previous->getMuxPinMode();
+            if (previousMode < mode) break;
+            if (previousMode == mode && grayRank(previous->getMuxChannel()) <= rank) break;
+            this->objects[j] = this->objects[j - 1];
+            --j;
+        }
+        this->objects[j] = object;
     }
-    if (this->objectCount == this->capacity) {
-        resize();
-        if (this->objectCount == this->capacity) return false;
+    this->highCount = 0;
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        this->objects[i]->muxIndex = i;
+        if (this->objects[i]->getScanPriority() == CtrlBase::PRIORITY_HIGH) ++this->highCount;
     }
-    this->objects[this->objectCount++] = object;
-    object->mux = this;
-    object->muxed = true;
-    return true;
 }
 
-void CtrlMux::removeObject(Muxable* object) {
+void CtrlMux::refreshScanPlan()
+{
+    this->usedChannels = 0;
+    this->analogChannels = 0;
     for (size_t i = 0; i < this->objectCount; ++i) {
-        if (this->objects[i] == object) {
-            object->mux = nullptr;
-            object->muxed = false;
-            for (size_t j = i; j < this->objectCount - 1; ++j) {
-                this->objects[j] = this->objects[j + 1];
-            }
-            --this->objectCount;
-            if (this->objectCount == 0 || this->nextIndex >= this->objectCount) {
-                this->nextIndex = 0;
-            }
-            return;
+        const Muxable* object = this->objects[i];
+        const uint16_t mask = object->getMuxChannelMask();
+        this->usedChannels |= mask;
+        if (object->isMuxAnalog()) this->analogChannels |= mask;
+        for (uint8_t channel = 0; channel < 16; ++channel) {
+            if (bitRead(mask, channel)) this->channelPinModes[channel] = object->getMuxPinMode();
+        }
+    }
+}
+
+void CtrlMux::prepareChannel(const uint8_t channel)
+{
+    if (bitRead(this->usedChannels, channel)) this->setPinMode(this->channelPinModes[channel]);
+}
+
+bool CtrlMux::keepsPinMode(const uint8_t channel) const
+{
+    return !bitRead(this->usedChannels, channel) || this->channelPinModes[channel] == this->currentPinMode;
+}
+
+void CtrlMux::sampleChannel(const uint8_t channel)
+{
+    if (!bitRead(this->usedChannels, channel)) return;
+    const uint16_t bit = static_cast<uint16_t>(1u << channel);
+    if (this->analogChannels & bit) {
+        this->analogFrame[channel] = this->sigPin.readAnalog();
+    } else if (this->sigPin.read()) {
+        this->digitalFrame |= bit;
+    } else {
+        this->digitalFrame &= ~bit;
+    }
+    this->frameValid |= bit;
+}
+
+uint8_t CtrlMux::nextSweepChannel(const uint16_t pending, CtrlMux* const* muxes, const uint8_t muxCount)
+{
+    // The first channel in Gray-code order that keeps the pin modes, else the first channel.
+    uint8_t first = UINT8_MAX;
+    for (uint8_t rank = 0; rank < 16; ++rank) {
+        const uint8_t channel = rank ^ (rank >> 1);
+        if (!bitRead(pending, channel)) continue;
+        bool keeps = true;
+        for (uint8_t i = 0; i < muxCount && keeps; ++i) {
+            keeps = muxes[i]->keepsPinMode(channel);
         }
+        if (keeps) return channel;
+        if (first == UINT8_MAX) first = channel;
+    }
+    return first;
+}
+
+void CtrlMux::sweep(const uint16_t channels)
+{
+    const uint16_t channelMask = static_cast<uint16_t>((1ul << this->selectLines.getChannelCount()) - 1);
+    uint16_t pending = channels & this->usedChannels & channelMask & ~this->frameValid;
+    CtrlMux* const self = this;
+    while (pending != 0) {
+        const uint8_t channel = nextSweepChannel(pending, &self, 1);
+        this->prepareChannel(channel);
+        this->setChannel(channel);
+        CtrlDelay::wait(this->switchInterval);
+        this->sampleChannel(channel);
+        pending &= static_cast<uint16_t>(~(1u << channel));
     }
 }
 
 void CtrlMux::process(const uint8_t count)
 {
     if (this->objectCount == 0) return;
+    const CtrlClock::Pass pass; // All objects of the pass share one timestamp.
+    const CtrlDeferredEvents::Phase phase(this->deferredEvents); // Fires the held back events on return.
     this->initialize();
-    if (count == 0) {
-        for (size_t i = 0; i < this->objectCount; ++i) {
-            this->objects[i]->process();
-        }
-    } else {
-        const uint8_t n = count > this->objectCount ? static_cast<uint8_t>(this->objectCount) : count;
-        for (uint8_t i = 0; i < n; ++i) {
-            this->objects[this->nextIndex]->process();
-            if (this->objectCount == 0) return;
-            this->nextIndex = (this->nextIndex + 1) % this->objectCount;
+    this->updateScanPlan();
+    // A full pass does not move the round-robin position.
+    CtrlSliceCursor fullPass;
+    CtrlSliceCursor& cursor = count == 0 ? fullPass : this->cursor;
+    CtrlSlice<Muxable> slice(count, this->objectCount, this->highCount);
+    slice.setIdleScan(this->idleScan);
+    if (this->scanMode == PIPELINED) {
+        this->processPipelined(slice, cursor);
+        this->frameValid = 0;
+        return;
+    }
+    if (this->scanMode == SNAPSHOT) {
+        uint16_t channels = this->usedChannels;
+        if (count > 0) {
+            channels = 0;
+            CtrlSlice<Muxable> lookahead = slice;
+            CtrlSliceCursor position = cursor;
+            while (const Muxable* object = lookahead.next(this->objects, this->objectCount, this->highCount, position)) {
+                channels |= object->getMuxChannelMask();
+            }
         }
+        this->sweep(channels);
+    }
+    while (Muxable* object = slice.next(this->objects, this->objectCount, this->highCount, cursor)) {
+        object->process();
+        if (this->objectCount == 0) break;
     }
+    this->frameValid = 0;
 }
 
 bool CtrlMux::readDigitalChannel(const uint8_t channel, const uint8_t pinModeType)
 {
     this->initialize();
-    const uint8_t maxChannel = this->s3Present ? 15 : 7;
-    if (channel > maxChannel) return false;
+    if (channel >= this->selectLines.getChannelCount()) return false;
+    if (bitRead(this->frameValid, channel)) return bitRead(this->digitalFrame, channel);
     this->setPinMode(pinModeType);
     this->setChannel(channel);
-    delayMicroseconds(this->switchInterval);
-    return digitalRead(this->sig);
+    CtrlDelay::wait(this->switchInterval);
+    return this->sigPin.read();
 }
 
 uint16_t CtrlMux::readAnalogChannel(const uint8_t channel, const uint8_t pinModeType)
 {
     this->initialize();
-    const uint8_t maxChannel = this->s3Present ? 15 : 7;
-    if (channel > maxChannel) return 0;
+    if (channel >= this->selectLines.getChannelCount()) return 0;
+    if (bitRead(this->frameValid, channel)) return this->analogFrame[channel];
     this->setPinMode(pinModeType);
     this->setChannel(channel);
-    delayMicroseconds(this->switchInterval);
-    return analogRead(this->sig);
+    CtrlDelay::wait(this->switchInterval);
+    return this->sigPin.readAnalog();
 }
 
 bool CtrlMux::readBtnSig(const uint8_t channel, const uint8_t pinModeType)
@@ -174,32 +327,81 @@ uint16_t CtrlMux::readPotSig(const uint8_t channel, const uint8_t pinModeType)
     return this->readAnalogChannel(channel, pinModeType);
 }
 
-void CtrlMux::setSwitchInterval(const uint8_t interval)
+uint32_t CtrlMux::readBtnBits(const uint8_t channel, const uint8_t count, const uint8_t pinModeType)
 {
-    this->switchInterval = interval < 1 ? 1 : interval;
+    if (channel >= 16 || count == 0) return 0;
+    const uint16_t runMask = static_cast<uint16_t>(((count >= 16 ? 0xfffful : (1ul << count) - 1)) << channel);
+    // Straight from the frame when the whole run was sampled this pass.
+    if ((this->frameValid & runMask) == runMask) return (this->digitalFrame & runMask) >> channel;
+    return CtrlSource::readBtnBits(channel, count, pinModeType);
 }
 
-void CtrlMux::reserve(const size_t capacity) {
-    if (capacity <= this->capacity) return;
-    auto** newObjects = new (std::nothrow) Muxable*[capacity];
-    if (newObjects == nullptr) return;
-    for (size_t i = 0; i < this->objectCount; ++i) {
-        newObjects[i] = this->objects[i];
+uint16_t CtrlMux::pendingChannels(const Muxable* object) const
+{
+    const uint16_t channelMask = static_cast<uint16_t>((1ul << this->selectLines.getChannelCount()) - 1);
+    return object->getMuxChannelMask() & this->usedChannels & channelMask & ~this->frameValid;
+}
+
+void CtrlMux::processPipelined(CtrlSlice<Muxable>& slice, CtrlSliceCursor& cursor)
+{
+    Muxable* object = slice.next(this->objects, this->objectCount, this->highCount, cursor);
+    uint8_t channel = this->nextPipelineChannel(object, slice, cursor);
+    uint32_t selectedAt = 0;
+    if (channel != UINT8_MAX) {
+        this->prepareChannel(channel);
+        this->setChannel(channel);
+        selectedAt = CtrlDelay::now();
+    }
+    while (object != nullptr && this->objectCount > 0) {
+        if (this->pendingChannels(object) == 0) {
+            // All channels of this object are sampled: process it while the next one settles.
+            object->process();
+            object = slice.next(this->objects, this->objectCount, this->highCount, cursor);
+            continue;
+        }
+        CtrlDelay::waitSince(selectedAt, this->switchInterval);
+        this->sampleChannel(channel);
+        channel = this->nextPipelineChannel(object, slice, cursor);
+        if (channel != UINT8_MAX) {
+            this->prepareChannel(channel);
+            this->setChannel(channel);
+            selectedAt = CtrlDelay::now();
+        }
     }
-    delete[] this->objects;
-    this->objects = newObjects;
-    this->capacity = capacity;
 }
 
-void CtrlMux::resize() {
-    const size_t newCapacity = this->capacity == 0 ? 4 : this->capacity * 2;
-    if (newCapacity <= this->capacity) return;
-    auto** newObjects = new (std::nothrow) Muxable*[newCapacity];
-    if (newObjects == nullptr) return;
-    for (size_t i = 0; i < this->objectCount; ++i) {
-        newObjects[i] = this->objects[i];
+uint8_t CtrlMux::nextPipelineChannel(const Muxable* object, CtrlSlice<Muxable> slice, CtrlSliceCursor cursor) const
+{
+    while (object != nullptr) {
+        const uint16_t pending = this->pendingChannels(object);
+        if (pending != 0) {
+            for (uint8_t rank = 0; rank < 16; ++rank) {
+                const uint8_t channel = rank ^ (rank >> 1);
+                if (bitRead(pending, channel)) return channel;
+            }
+        }
+        object = slice.next(this->objects, this->objectCount, this->highCount, cursor);
     }
-    delete[] this->objects;
-    this->objects = newObjects;
-    this->capacity = newCapacity;
-}
\ No newline at end of file
+    return UINT8_MAX;
+}
+
+void CtrlMux::setSwitchInterval(const uint8_t interval)
+{
+    this->switchInterval = (interval < 1 ? 1 : interval) * 1000UL;
+}
+
+void CtrlMux::setSwitchIntervalNs(const uint32_t interval)
+{
+    this->switchInterval = interval;
+}
+
+void CtrlMux::setScanMode(const ScanMode mode)
+{
+    // Without fine timestamps, waitSince() rounds every switch interval up to the next clock step.
+    this->scanMode = mode == PIPELINED && !CtrlDelay::FINE_TIMESTAMPS ? SNAPSHOT : mode;
+}
+
+CtrlMux::ScanMode CtrlMux::getScanMode() const
+{
+    return this->scanMode;
+}
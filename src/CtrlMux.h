@@ -29,32 +29,144 @@
 #define CTRLMUX_H
 
 #include <Arduino.h>
+#include "CtrlPinIO.h"
+#include "CtrlSource.h"
 
 class Muxable;
+class CtrlMuxBus;
 
-class CtrlMux
+class CtrlMux : public CtrlSource
 {
+    friend class CtrlMuxBus;
+
+    public:
+        enum ScanMode : uint8_t {
+            DIRECT, // Every object reads its own channel(s) while it is processed.
+            SNAPSHOT, // All channels are sampled into a frame first, objects decode from the frame.
+            PIPELINED // The next channel settles while the previous object is processed.
+        };
+
     protected:
         uint8_t sig;
-        uint8_t s0;
-        uint8_t s1;
-        uint8_t s2;
-        uint8_t s3;
-        bool s3Present;
-        uint8_t switchInterval = 1; // In microseconds
+        CtrlPin sigPin;
+        CtrlSelectLines selectLines;
+        uint32_t switchInterval = 1000; // In nanoseconds
         uint8_t currentPinMode = 0;
-        Muxable** objects = nullptr;
-        size_t objectCount = 0;
-        size_t capacity = 0;
-        size_t nextIndex = 0;
+        ScanMode scanMode = DIRECT;
+        CtrlMuxBus* bus = nullptr;
+        uint16_t usedChannels = 0; // Bitmask of the channels read by the objects.
+        uint16_t analogChannels = 0; // Bitmask of the channels read as analog.
+        uint8_t channelPinModes[16] = {};
+        uint16_t frameValid = 0; // Bitmask of the channels sampled into the frame this pass.
+        uint16_t digitalFrame = 0;
+        uint16_t analogFrame[16] = {};
 
         bool initialized = false;
 
         void initialize();
 
+        void beginPass() override;
+
+        void endPass() override;
+
         void setPinMode(uint8_t pinModeType);
 
-        void setChannel(uint8_t channel) const;
+        virtual void setChannel(uint8_t channel);
+
+        /**
+        * @brief Take over the select lines from any other multiplexer sharing them.
+        */
+        void claimSelectLines();
+
+        /**
+        * @brief Instantiate a Multiplexer object with fixed object storage.
+        *
+        * Used by CtrlMuxT. The storage is never reallocated nor deleted.
+        */
+        CtrlMux(
+            uint8_t sig,
+            uint8_t s0,
+            uint8_t s1,
+            uint8_t s2,
+            uint8_t s3,
+            Muxable** storage,
+            size_t capacity
+        );
+
+        CtrlMux(
+            uint8_t sig,
+            CtrlMuxBus* bus,
+            Muxable** storage,
+            size_t capacity
+        );
+
+        /**
+        * @brief Reorder the objects into an optimized scan plan.
+        *
+        * High priority objects come first (see process(count)). Then objects
+        * are grouped by pin mode (so the signal pin mode only changes once per
+        * group) and, within a group, ordered by channel in Gray-code order (so
+        * consecutive reads only toggle a single select line).
+        */
+        void buildScanPlan() override;
+
+        /**
+        * @brief Collect the channels in use, and their pin modes.
+        */
+        void refreshScanPlan() override;
+
+        /**
+        * @brief Set the pin mode of a channel, before it is selected, so it settles too.
+        */
+        void prepareChannel(uint8_t channel);
+
+        /**
+        * @brief Whether sampling a channel keeps the current pin mode.
+        */
+        [[nodiscard]] bool keepsPinMode(uint8_t channel) const;
+
+        /**
+        * @brief Sample a channel into the frame, if any object reads it.
+        *
+        * The pin mode must already be set (see prepareChannel()), the channel
+        * selected, and the multiplexer settled.
+        */
+        void sampleChannel(uint8_t channel);
+
+        /**
+        * @brief The next of the pending channels to sweep, for the given multiplexers.
+        *
+        * The first channel in Gray-code order that keeps the pin mode of every
+        * multiplexer, or else the first channel in Gray-code order.
+        */
+        static uint8_t nextSweepChannel(uint16_t pending, CtrlMux* const* muxes, uint8_t muxCount);
+
+        /**
+        * @brief Sample the given channels into the frame, each exactly once.
+        *
+        * Channels are grouped by pin mode (the current one first), and visited
+        * in Gray-code order within a group. Channels that are already in the
+        * frame (e.g. sampled by the bus) are skipped. Pin modes are set before
+        * the channel is selected, so they settle with it.
+        */
+        void sweep(uint16_t channels);
+
+        /**
+        * @brief The channels of an object that are not sampled into the frame yet.
+        */
+        uint16_t pendingChannels(const Muxable* object) const;
+
+        /**
+        * @brief Process the objects of a slice while the next channel settles.
+        */
+        void processPipelined(CtrlSlice<Muxable>& slice, CtrlSliceCursor& cursor);
+
+        /**
+        * @brief The next channel still needed by the given object, or the rest of the slice.
+        *
+        * @return The channel, or UINT8_MAX when all their channels are in the frame.
+        */
+        uint8_t nextPipelineChannel(const Muxable* object, CtrlSlice<Muxable> slice, CtrlSliceCursor cursor) const;
 
     public:
         /**
@@ -78,30 +190,23 @@ class CtrlMux
             uint8_t s3 = UINT8_MAX // Default to a value indicating S3 is not used
         );
 
-        ~CtrlMux();
-
-        CtrlMux(const CtrlMux&) = delete;
-        CtrlMux& operator=(const CtrlMux&) = delete;
-        CtrlMux(CtrlMux&&) = delete;
-        CtrlMux& operator=(CtrlMux&&) = delete;
-
-        /**
-        * @brief Add an object to the mux.
-        *
-        * @param object Object to be added to the mux.
-        */
-        bool addObject(Muxable* object);
-
-        void removeObject(Muxable* object);
-
         /**
-        * @brief Pre-allocate capacity for a known number of objects.
+        * @brief Instantiate a Multiplexer object on a shared select bus.
         *
-        * Call this before adding objects to avoid heap allocations during runtime.
+        * Use this for daisy-chained multiplexers that share their channel
+        * select lines. The bus drives the select lines, and samples all of its
+        * multiplexers per channel. Define the bus before the multiplexer.
         *
-        * @param capacity The number of objects to pre-allocate space for.
+        * @param sig (uint8_t) The signal (SIG) pin of the multiplexer.
+        * @param bus (CtrlMuxBus) The bus that owns the channel select pins.
+        * @return A new instance of the CtrlMux class.
         */
-        void reserve(size_t capacity);
+        CtrlMux(
+            uint8_t sig,
+            CtrlMuxBus* bus
+        );
+
+        ~CtrlMux() override;
 
         /**
         * @brief The process method should be called within the loop method.
@@ -114,12 +219,27 @@ class CtrlMux
         * iteration.
         *
         * Note: each channel read incurs a blocking delay of switchInterval
-        * microseconds (default: 1µs) for the multiplexer to settle. When
-        * processing N objects per call, the minimum blocking time is N * switchInterval
-        * microseconds — independent of analogRead() or digitalRead() costs. Factor
-        * this into your loop budget when sizing the count parameter.
+        * (default: 1µs) for the multiplexer to settle. When processing N objects
+        * per call, the minimum blocking time is N * switchInterval — independent
+        * of analogRead() or digitalRead() costs. Factor this into your loop
+        * budget when sizing the count parameter.
+        *
+        * Objects are scanned in an optimized order: grouped by pin mode, then
+        * by channel in Gray-code order. The scan plan is rebuilt on the first
+        * call after objects have been added or removed.
+        *
+        * processFor() reads the channels per object, as in the DIRECT scan
+        * mode, so the time estimate of an object includes its reads.
+        *
+        * With count > 0, objects with CtrlBase::PRIORITY_HIGH (e.g. encoders)
+        * are serviced on every call, the remaining slots go round-robin to the
+        * others, where PRIORITY_LOW objects (e.g. potentiometers) only get a turn
+        * every CtrlBase::LOW_PRIORITY_INTERVAL rounds. Never more than count
+        * objects are processed per call. Keep count larger than the number of
+        * high priority objects: at least one slot is kept for the others, but
+        * the high priority objects then take turns.
         */
-        void process(uint8_t count = 0);
+        void process(uint8_t count = 0) override;
 
         /**
         * @brief Set the switch interval of the multiplexer.
@@ -135,15 +255,155 @@ class CtrlMux
         */
         void setSwitchInterval(uint8_t interval);
 
-        [[nodiscard]] bool readBtnSig(uint8_t channel, uint8_t pinModeType);
-        [[nodiscard]] bool readEncClk(uint8_t channel, uint8_t pinModeType);
-        [[nodiscard]] bool readEncDt(uint8_t channel, uint8_t pinModeType);
-        [[nodiscard]] uint16_t readPotSig(uint8_t channel, uint8_t pinModeType);
+        /**
+        * @brief Set the switch interval of the multiplexer in nanoseconds.
+        *
+        * A 74HC4067 settles in about 100 - 200 ns, much less than the 1
+        * microsecond minimum of setSwitchInterval(). How precise the wait is
+        * depends on the board (see CtrlDelay.h): the cycle counter of Cortex-M3/M4/M7
+        * boards gets down to a few nanoseconds, AVR boards wait in steps of
+        * 4 cpu cycles (250 ns at 16 MHz), other boards round up to whole
+        * microseconds.
+        *
+        * @param interval (uint32_t) The switch interval (in nanoseconds).
+        */
+        void setSwitchIntervalNs(uint32_t interval);
+
+        /**
+        * @brief Set the scan mode of the multiplexer.
+        *
+        * - CtrlMux::DIRECT (default): each object switches to, and reads, its
+        *   own channel(s) while it is being processed.
+        * - CtrlMux::SNAPSHOT: at the start of every pass, each used channel is
+        *   read exactly once into a frame (a bitmask for digital channels, a
+        *   value per analog channel). Objects then decode from that frame without
+        *   any further I/O. Both phases of an encoder are sampled in the same
+        *   sweep, and channels shared by several objects are only read once.
+        *   With process(count), only the channels of the objects serviced in
+        *   that call are swept.
+        * - CtrlMux::PIPELINED: like SNAPSHOT, but right after a channel is sampled
+        *   the next one is selected, and the objects that have all their channels
+        *   sampled are processed while the multiplexer settles. The clock is only
+        *   used to confirm that the switch interval has passed, so there is
+        *   hardly any busy-waiting left. On AVR, whose micros() counts in 4 us
+        *   steps, that confirmation would pad every switch: PIPELINED falls
+        *   back to SNAPSHOT there, which still reads every channel once per
+        *   pass. Use getScanMode() to see the mode in use.
+        *
+        * @param mode The scan mode.
+        */
+        void setScanMode(ScanMode mode);
+
+        /**
+        * @brief Get the scan mode in use, which may differ from the one set.
+        *
+        * @return The scan mode.
+        */
+        [[nodiscard]] ScanMode getScanMode() const;
+
+        [[nodiscard]] bool readBtnSig(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] bool readEncClk(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] bool readEncDt(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] uint16_t readPotSig(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] uint32_t readBtnBits(uint8_t channel, uint8_t count, uint8_t pinModeType) override;
 
     private:
         bool readDigitalChannel(uint8_t channel, uint8_t pinModeType);
         uint16_t readAnalogChannel(uint8_t channel, uint8_t pinModeType);
-        void resize();
+};
+
+/**
+* @brief A multiplexer with a compile-time channel count and object capacity.
+*
+* Behaves like CtrlMux, but the objects are stored in a fixed array inside
+* the multiplexer, so it never allocates heap memory (not even from static
+* constructors). Adding more than MaxObjects objects fails.
+*
+* The number of select lines follows from Channels, so the select line writes
+* are unrolled by the compiler. With 16 channels the s3 pin is required.
+*
+* @tparam Channels The number of channels: 8 (s0 - s2) or 16 (s0 - s3).
+* @tparam MaxObjects The maximum number of objects on this multiplexer.
+*/
+template <uint8_t Channels, size_t MaxObjects>
+class CtrlMuxT : public CtrlMux
+{
+    static_assert(Channels == 8 || Channels == 16, "CtrlMuxT supports 8 or 16 channels.");
+    static_assert(MaxObjects > 0, "CtrlMuxT needs room for at least one object.");
+
+    protected:
+        Muxable* storage[MaxObjects] = {};
+
+        void setChannel(const uint8_t channel) override
+        {
+            if (this->bus != nullptr) {
+                CtrlMux::setChannel(channel);
+                return;
+            }
+            // The configured pins decide, in case s3 was passed as UINT8_MAX.
+            const uint8_t channels = this->selectLines.getChannelCount();
+            if (channel >= Channels || channel >= channels) return;
+            this->claimSelectLines();
+            if (Channels == 16 && channels == 16) {
+                this->selectLines.template select<4>(channel);
+            } else {
+                this->selectLines.template select<3>(channel);
+            }
+        }
+
+    public:
+        /**
+        * @brief Instantiate a statically sized 8 channel Multiplexer object.
+        *
+        * @param sig (uint8_t) The signal (SIG) pin of the multiplexer.
+        * @param s0 (uint8_t) The s0 channelselect pin.
+        * @param s1 (uint8_t) The s1 channelselect pin.
+        * @param s2 (uint8_t) The s2 channelselect pin.
+        * @return A new instance of the CtrlMuxT class.
+        */
+        CtrlMuxT(
+            const uint8_t sig,
+            const uint8_t s0,
+            const uint8_t s1,
+            const uint8_t s2
+        ) : CtrlMux(sig, s0, s1, s2, UINT8_MAX, this->storage, MaxObjects)
+        {
+            static_assert(Channels == 8, "A 16 channel CtrlMuxT needs the s3 pin.");
+        }
+
+        /**
+        * @brief Instantiate a statically sized Multiplexer object.
+        *
+        * @param sig (uint8_t) The signal (SIG) pin of the multiplexer.
+        * @param s0 (uint8_t) The s0 channelselect pin.
+        * @param s1 (uint8_t) The s1 channelselect pin.
+        * @param s2 (uint8_t) The s2 channelselect pin.
+        * @param s3 (uint8_t) The s3 channel select pin, ignored with 8 channels.
+        * @return A new instance of the CtrlMuxT class.
+        */
+        CtrlMuxT(
+            const uint8_t sig,
+            const uint8_t s0,
+            const uint8_t s1,
+            const uint8_t s2,
+            const uint8_t s3
+        ) : CtrlMux(sig, s0, s1, s2, Channels == 16 ? s3 : UINT8_MAX, this->storage, MaxObjects)
+        {
+        }
+
+        /**
+        * @brief Instantiate a statically sized Multiplexer object on a shared select bus.
+        *
+        * @param sig (uint8_t) The signal (SIG) pin of the multiplexer.
+        * @param bus (CtrlMuxBus) The bus that owns the channel select pins.
+        * @return A new instance of the CtrlMuxT class.
+        */
+        CtrlMuxT(
+            const uint8_t sig,
+            CtrlMuxBus* bus
+        ) : CtrlMux(sig, bus, this->storage, MaxObjects)
+        {
+        }
 };
 
 #endif // CTRLMUX_H
\ No newline at end of file
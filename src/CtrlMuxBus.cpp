@@ -0,0 +1,128 @@
+/*!
+ *  @file       CtrlMuxBus.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CtrlMuxBus.h"
+#include "CtrlDelay.h"
+#include "CtrlMux.h"
+
+CtrlMuxBus::CtrlMuxBus(
+    const uint8_t s0,
+    const uint8_t s1,
+    const uint8_t s2,
+    const uint8_t s3
+) : selectLines(s0, s1, s2, s3)
+{
+}
+
+CtrlMuxBus::~CtrlMuxBus()
+{
+    for (uint8_t i = 0; i < this->muxCount; ++i) {
+        this->muxes[i]->bus = nullptr;
+    }
+}
+
+void CtrlMuxBus::initialize()
+{
+    if (this->initialized) return;
+    this->selectLines.begin();
+    this->initialized = true;
+}
+
+void CtrlMuxBus::setChannel(const uint8_t channel)
+{
+    this->initialize();
+    this->selectLines.select(channel);
+}
+
+bool CtrlMuxBus::addMux(CtrlMux* mux)
+{
+    if (mux == nullptr) return false;
+    for (uint8_t i = 0; i < this->muxCount; ++i) {
+        if (this->muxes[i] == mux) return true;
+    }
+    if (this->muxCount >= MAX_MUXES) return false;
+    if (mux->bus != nullptr) mux->bus->removeMux(mux);
+    this->muxes[this->muxCount++] = mux;
+    mux->bus = this;
+    return true;
+}
+
+void CtrlMuxBus::removeMux(CtrlMux* mux)
+{
+    for (uint8_t i = 0; i < this->muxCount; ++i) {
+        if (this->muxes[i] == mux) {
+            mux->bus = nullptr;
+            for (uint8_t j = i; j < this->muxCount - 1; ++j) {
+                this->muxes[j] = this->muxes[j + 1];
+            }
+            --this->muxCount;
+            return;
+        }
+    }
+}
+
+void CtrlMuxBus::process()
+{
+    if (this->muxCount == 0) return;
+    const CtrlClock::Pass pass; // All objects of the pass share one timestamp.
+    uint16_t usedChannels = 0;
+    for (uint8_t i = 0; i < this->muxCount; ++i) {
+        CtrlMux* mux = this->muxes[i];
+        mux->initialize();
+        mux->updateScanPlan();
+        usedChannels |= mux->usedChannels;
+    }
+    // Walk the used channels grouped by pin mode, and in Gray-code order, so
+    // each step toggles one select line. Pin modes are set before the select
+    // lines, so they settle too.
+    uint16_t pending = usedChannels & static_cast<uint16_t>((1ul << this->selectLines.getChannelCount()) - 1);
+    while (pending != 0) {
+        const uint8_t channel = CtrlMux::nextSweepChannel(pending, this->muxes, this->muxCount);
+        for (uint8_t i = 0; i < this->muxCount; ++i) {
+            this->muxes[i]->prepareChannel(channel);
+        }
+        this->setChannel(channel);
+        CtrlDelay::wait(this->switchInterval);
+        for (uint8_t i = 0; i < this->muxCount; ++i) {
+            this->muxes[i]->sampleChannel(channel);
+        }
+        pending &= static_cast<uint16_t>(~(1u << channel));
+    }
+    for (uint8_t i = 0; i < this->muxCount; ++i) {
+        this->muxes[i]->process();
+    }
+}
+
+void CtrlMuxBus::setSwitchInterval(const uint8_t interval)
+{
+    this->switchInterval = (interval < 1 ? 1 : interval) * 1000UL;
+}
+
+void CtrlMuxBus::setSwitchIntervalNs(const uint32_t interval)
+{
+    this->switchInterval = interval;
+}
\ No newline at end of file
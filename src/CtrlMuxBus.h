@@ -0,0 +1,124 @@
+/*!
+ *  @file       CtrlMuxBus.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLMUXBUS_H
+#define CTRLMUXBUS_H
+
+#include <Arduino.h>
+#include "CtrlPinIO.h"
+
+class CtrlMux;
+
+class CtrlMuxBus
+{
+    friend class CtrlMux;
+
+    protected:
+        static constexpr uint8_t MAX_MUXES = 8;
+
+        CtrlSelectLines selectLines;
+        uint32_t switchInterval = 1000; // In nanoseconds
+        CtrlMux* muxes[MAX_MUXES] = {};
+        uint8_t muxCount = 0;
+
+        bool initialized = false;
+
+        void initialize();
+
+        void setChannel(uint8_t channel);
+
+    public:
+        /**
+        * @brief Instantiate a multiplexer bus object.
+        *
+        * The CtrlMuxBus class owns the channel select lines that are shared by
+        * a number of daisy-chained multiplexers. Each channel is selected once
+        * per pass, and after a single settle delay the signal pin of every
+        * attached multiplexer is sampled, before moving on to the next channel.
+        *
+        * @param s0 (uint8_t) The s0 channel select pin.
+        * @param s1 (uint8_t) The s1 channel select pin.
+        * @param s2 (uint8_t) The s2 channel select pin.
+        * @param s3 (uint8_t) (optional) The s3 channel select pin. Default is UINT8_MAX.
+        * @return A new instance of the CtrlMuxBus class.
+        */
+        CtrlMuxBus(
+            uint8_t s0,
+            uint8_t s1,
+            uint8_t s2,
+            uint8_t s3 = UINT8_MAX // Default to a value indicating S3 is not used
+        );
+
+        ~CtrlMuxBus();
+
+        CtrlMuxBus(const CtrlMuxBus&) = delete;
+        CtrlMuxBus& operator=(const CtrlMuxBus&) = delete;
+        CtrlMuxBus(CtrlMuxBus&&) = delete;
+        CtrlMuxBus& operator=(CtrlMuxBus&&) = delete;
+
+        /**
+        * @brief Attach a multiplexer to the bus.
+        *
+        * Multiplexers created with a reference to the bus are attached automatically.
+        *
+        * @param mux The multiplexer to be attached.
+        * @return True if the multiplexer is attached, false if the bus is full.
+        */
+        bool addMux(CtrlMux* mux);
+
+        void removeMux(CtrlMux* mux);
+
+        /**
+        * @brief The process method should be called within the loop method.
+        * It samples every used channel of all attached multiplexers and then
+        * handles the functionality of all their objects.
+        *
+        * Each used channel is selected once and waited on once (the switch
+        * interval), no matter how many multiplexers are attached.
+        */
+        void process();
+
+        /**
+        * @brief Set the switch interval of the bus.
+        *
+        * This is the amount of time we need to give the multiplexers in order to
+        * complete switching a channel. See CtrlMux::setSwitchInterval().
+        *
+        * @param interval (uint8_t) The switch interval (in microseconds).
+        */
+        void setSwitchInterval(uint8_t interval);
+
+        /**
+        * @brief Set the switch interval of the bus in nanoseconds.
+        * See CtrlMux::setSwitchIntervalNs().
+        *
+        * @param interval (uint32_t) The switch interval (in nanoseconds).
+        */
+        void setSwitchIntervalNs(uint32_t interval);
+};
+
+#endif // CTRLMUXBUS_H
@@ -0,0 +1,47 @@
+/*!
+ *  @file       CtrlPinIO.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "CtrlPinIO.h"
+
+CtrlSelectLines::CtrlSelectLines(
+    const uint8_t s0,
+    const uint8_t s1,
+    const uint8_t s2,
+    const uint8_t s3
+) : pins { s0, s1, s2, s3 },
+    count(s3 != UINT8_MAX ? 4 : 3)
+{
+}
+
+void CtrlSelectLines::begin()
+{
+    for (uint8_t i = 0; i < this->count; ++i) {
+        pinMode(this->pins[i], OUTPUT);
+    }
+    CtrlPinIOBackend::attach(this->state, this->pins, this->count);
+    this->currentChannel = UINT8_MAX;
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+/*!
+ *  @file       CtrlPinIO.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLPINIO_H
+#define CTRLPINIO_H
+
+#include <Arduino.h>
+#include "CtrlBase.h"
+
+/*
+ * Pin I/O backends.
+ *
+ * All hot-path pin access of the library goes through one of the backends
+ * below, selected at compile time with a build flag:
+ *
+ * - (default)          CtrlPinIOArduino: pinMode, digitalWrite, digitalRead & analogRead.
+ * - CTRL_PIN_IO_PORT   CtrlPinIOPort: direct port register access (AVR). Pin lookups
+ *                      happen once, select lines sharing a port are written with a
+ *                      single masked port write.
+ * - CTRL_PIN_IO_MOCK   CtrlPinIOMock: the backend of the native test environment.
+ *
+ * Build flags must reach the library sources, e.g. 'build_flags = -D CTRL_PIN_IO_PORT'
+ * in platformio.ini. A #define in a sketch is not enough.
+ */
+
+struct CtrlPinIOArduino
+{
+    struct Pin { uint8_t number; };
+    struct Select { };
+
+    static void attach(Pin& pin, const uint8_t number) { pin.number = number; }
+
+    static void setMode(const uint8_t number, const uint8_t mode) { pinMode(number, mode); }
+
+    static bool read(const Pin& pin) { return digitalRead(pin.number); }
+
+    static uint16_t readAnalog(const Pin& pin) { return analogRead(pin.number); }
+
+    static void write(const Pin& pin, const bool value) { digitalWrite(pin.number, value); }
+
+    static void attach(Select&, const uint8_t*, uint8_t) { }
+
+    static void write(const Select&, const uint8_t* pins, const uint8_t count, const uint8_t channel, const uint8_t changed)
+    {
+        for (uint8_t i = 0; i < count; ++i) {
+            if (bitRead(changed, i)) digitalWrite(pins[i], bitRead(channel, i));
+        }
+    }
+};
+
+#if defined(ARDUINO_ARCH_AVR)
+struct CtrlPinIOPort
+{
+    struct Pin
+    {
+        volatile uint8_t* in;
+        volatile uint8_t* out;
+        uint8_t mask;
+        uint8_t number;
+    };
+
+    struct Select
+    {
+        volatile uint8_t* out[4];
+        uint8_t mask[4];
+        volatile uint8_t* sharedPort; // Set when all select lines are on the same port.
+        uint8_t sharedMask;
+    };
+
+    static void attach(Pin& pin, const uint8_t number)
+    {
+        const uint8_t port = digitalPinToPort(number);
+        pin.number = number;
+        pin.in = port == NOT_A_PIN ? nullptr : portInputRegister(port);
+        pin.out = port == NOT_A_PIN ? nullptr : portOutputRegister(port);
+        pin.mask = digitalPinToBitMask(number);
+    }
+
+    static void setMode(const uint8_t number, const uint8_t mode) { pinMode(number, mode); }
+
+    static bool read(const Pin& pin) { return pin.in != nullptr && (*pin.in & pin.mask) != 0; }
+
+    static uint16_t readAnalog(const Pin& pin) { return analogRead(pin.number); }
+
+    static void write(const Pin& pin, const bool value)
+    {
+        if (pin.out == nullptr) return;
+        const auto irqState = ctrlSaveInterrupts();
+        if (value) {
+            *pin.out |= pin.mask;
+        } else {
+            *pin.out &= ~pin.mask;
+        }
+        ctrlRestoreInterrupts(irqState);
+    }
+
+    static void attach(Select& select, const uint8_t* pins, const uint8_t count)
+    {
+        select.sharedPort = nullptr;
+        select.sharedMask = 0;
+        bool shared = true;
+        for (uint8_t i = 0; i < count; ++i) {
+            const uint8_t port = digitalPinToPort(pins[i]);
+            select.out[i] = port == NOT_A_PIN ? nullptr : portOutputRegister(port);
+            select.mask[i] = digitalPinToBitMask(pins[i]);
+            select.sharedMask |= select.mask[i];
+            if (select.out[i] == nullptr || select.out[i] != select.out[0]) shared = false;
+        }
+        if (shared) select.sharedPort = select.out[0];
+    }
+
+    static void write(const Select& select, const uint8_t*, const uint8_t count, const uint8_t channel, const uint8_t changed)
+    {
+        const auto irqState = ctrlSaveInterrupts();
+        if (select.sharedPort != nullptr) {
+            uint8_t bits = 0;
+            for (uint8_t i = 0; i < count; ++i) {
+                if (bitRead(channel, i)) bits |= select.mask[i];
+            }
+            *select.sharedPort = (*select.sharedPort & ~select.sharedMask) | bits;
+        } else {
+            for (uint8_t i = 0; i < count; ++i) {
+                if (!bitRead(changed, i) || select.out[i] == nullptr) continue;
+                if (bitRead(channel, i)) {
+                    *select.out[i] |= select.mask[i];
+                } else {
+                    *select.out[i] &= ~select.mask[i];
+                }
+            }
+        }
+        ctrlRestoreInterrupts(irqState);
+    }
+};
+#endif
+
+#if defined(CTRL_PIN_IO_MOCK)
+    #include "CtrlPinIOMock.h"
+    using CtrlPinIOBackend = CtrlPinIOMock;
+#elif defined(CTRL_PIN_IO_PORT) && defined(ARDUINO_ARCH_AVR)
+    using CtrlPinIOBackend = CtrlPinIOPort;
+#else
+    #if defined(CTRL_PIN_IO_PORT)
+        #warning "CTRL_PIN_IO_PORT is not supported on this architecture, falling back to the Arduino pin I/O backend."
+    #endif
+    using CtrlPinIOBackend = CtrlPinIOArduino;
+#endif
+
+/*
+ * A single pin, resolved once by the selected backend.
+ */
+class CtrlPin
+{
+    protected:
+        CtrlPinIOBackend::Pin state = {};
+
+    public:
+        void attach(const uint8_t number) { CtrlPinIOBackend::attach(this->state, number); }
+
+        void setMode(const uint8_t mode) const { CtrlPinIOBackend::setMode(this->state.number, mode); }
+
+        [[nodiscard]] bool read() const { return CtrlPinIOBackend::read(this->state); }
+
+        [[nodiscard]] uint16_t readAnalog() const { return CtrlPinIOBackend::readAnalog(this->state); }
+
+        void write(const bool value) const { CtrlPinIOBackend::write(this->state, value); }
+};
+
+/*
+ * The channel select lines (s0 - s3) of one or more multiplexers.
+ * Remembers the selected channel, so only the lines that change are written.
+ */
+class CtrlSelectLines
+{
+    protected:
+        uint8_t pins[4];
+        uint8_t count;
+        uint8_t currentChannel = UINT8_MAX; // UINT8_MAX = unknown
+        CtrlPinIOBackend::Select state = {};
+
+    public:
+        CtrlSelectLines(uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3 = UINT8_MAX);
+
+        /**
+        * @brief Configure the select pins as outputs.
+        */
+        void begin();
+
+        /**
+        * @brief Select a channel, writing only the select lines that change.
+        */
+        void select(const uint8_t channel)
+        {
+            if (channel == this->currentChannel) return;
+            const uint8_t changed = this->currentChannel == UINT8_MAX ? 0x0f : channel ^ this->currentChannel;
+            CtrlPinIOBackend::write(this->state, this->pins, this->count, channel, changed);
+            this->currentChannel = channel;
+        }
+
+        /**
+        * @brief Select a channel, with the number of select lines known at compile time.
+        *
+        * Lets the compiler unroll the write of the select lines.
+        */
+        template <uint8_t Lines>
+        void select(const uint8_t channel)
+        {
+            if (channel == this->currentChannel) return;
+            const uint8_t changed = this->currentChannel == UINT8_MAX ? 0x0f : channel ^ this->currentChannel;
+            CtrlPinIOBackend::write(this->state, this->pins, Lines, channel, changed);
+            this->currentChannel = channel;
+        }
+
+        /**
+        * @brief Forget the selected channel, e.g. when the lines were driven elsewhere.
+        */
+        void invalidate() { this->currentChannel = UINT8_MAX; }
+
+        [[nodiscard]] uint8_t getPin(const uint8_t index) const { return index < this->count ? this->pins[index] : UINT8_MAX; }
+
+        [[nodiscard]] uint8_t getChannelCount() const { return this->count == 4 ? 16 : 8; }
+};
+
+#endif // CTRLPINIO_H
@@ -33,9 +33,10 @@ CtrlPot::CtrlPot(
     const int maxOutputValue,
     const float sensitivity,
     const CallbackFunction onValueChangeCallback,
-    CtrlMux* mux
+    CtrlSource* mux
 ) : Muxable(mux) {
     this->sig = sig;
+    this->sigPin.attach(sig);
     this->maxOutputValue = maxOutputValue < 0 ? 0 : maxOutputValue;
     setSensitivity(sensitivity);
     this->onValueChangeCallback = onValueChangeCallback;
@@ -103,7 +104,7 @@ void CtrlPot::setOnValueChange(const CallbackFunction callback)
 
 void CtrlPot::initialize()
 {
-    if (!this->isMuxed()) pinMode(sig, INPUT);
+    if (!this->isMuxed()) this->sigPin.setMode(INPUT);
     this->lastValue = this->processInput();
     this->smoothedValue_q16 = static_cast<uint32_t>(this->lastValue) << 16;
     this->initialized = true;
@@ -111,13 +112,25 @@ void CtrlPot::initialize()
 
 bool CtrlPot::isInitialized() const { return this->initialized; }
 
+uint8_t CtrlPot::getMuxChannel() const { return this->sig; }
+
+uint8_t CtrlPot::getMuxPinMode() const { return this->pinModeType; }
+
+uint8_t CtrlPot::getScanPriority() const { return this->priority; }
+
+bool CtrlPot::isScanIdle(const unsigned long now, const unsigned long timeout) const { return this->isIdleFor(now, timeout); }
+
+bool CtrlPot::isMuxAnalog() const { return true; }
+
+void CtrlPot::storeMuxValue(const uint16_t value) { this->storeRaw(value); }
+
 uint16_t CtrlPot::processInput()
 {
     uint16_t rawValue;
     if (this->isMuxed()) {
         rawValue = this->mux->readPotSig(this->sig, this->pinModeType);
     } else {
-        rawValue = analogRead(this->sig);
+        rawValue = this->sigPin.readAnalog();
     }
     return this->applySmoothing(rawValue);
 }
@@ -140,6 +153,7 @@ uint16_t CtrlPot::applySmoothing(const uint16_t rawValue)
 void CtrlPot::processSmoothedValue(const uint16_t newValue)
 {
     if (newValue != this->lastValue) {
+        this->markActivity(CtrlClock::now());
         const uint16_t mappedValue = static_cast<uint16_t>(
             (static_cast<uint32_t>(newValue) * this->maxOutputValue + (this->analogMax / 2)) / this->analogMax
         );
@@ -151,8 +165,14 @@ void CtrlPot::processSmoothedValue(const uint16_t newValue)
     }
 }
 
+void CtrlPot::fireEvent(const CtrlEvent::Type type, const int32_t value)
+{
+    if (type == CtrlEvent::VALUE_CHANGE) this->onValueChange(value);
+}
+
 void CtrlPot::onValueChange(const int value)
 {
+    if (this->queueEvent(CtrlEvent::VALUE_CHANGE, value) || this->deferEvent(CtrlEvent::VALUE_CHANGE, value)) return;
     const auto callback = this->onValueChangeCallback;
     if (this->isGrouped() && this->group->onValueChangeCallback) {
         this->group->onValueChangeCallback(*this, value);
@@ -30,7 +30,9 @@
 
 #include <Arduino.h>
 #include "CtrlBase.h"
+#include "CtrlClock.h"
 #include "CtrlMux.h"
+#include "CtrlPinIO.h"
 #include "Groupable.h"
 #include "Muxable.h"
 
@@ -38,6 +40,7 @@ class CtrlPot : public CtrlBase, public Muxable, public Groupable
 {
     protected:
         uint8_t sig; // Analog pin connected to the potentiometer.
+        CtrlPin sigPin;
         uint8_t pinModeType = INPUT;
         uint16_t lastValue = 0; // Last read value from the potentiometer.
         uint16_t lastMappedValue = 0; // Last mapped value based on a mapping to maxOutputValue.
@@ -63,7 +66,7 @@ class CtrlPot : public CtrlBase, public Muxable, public Groupable
         * @param maxOutputValue (int) The maximum output value of the potentiometer.
         * @param sensitivity (float) The sensitivity factor. Decrease this for instable (jittery) pots, min: 0.01, max: 100.
         * @param onValueChangeCallback (optional) The on value change callback handler. Default is nullptr.
-        * @param mux (CtrlMux) (optional) The multiplexer the pot is connected to. Default is nullptr.
+        * @param mux (CtrlSource) (optional) The multiplexer (or other source, e.g. CtrlShiftIn) the pot is connected to. Default is nullptr.
         * @return A new instance of the CtrlPot class.
         */
         CtrlPot(
@@ -71,7 +74,7 @@ class CtrlPot : public CtrlBase, public Muxable, public Groupable
             int maxOutputValue,
             float sensitivity,
             CallbackFunction onValueChangeCallback = nullptr,
-            CtrlMux* mux = nullptr
+            CtrlSource* mux = nullptr
         );
 
         /**
@@ -79,6 +82,11 @@ class CtrlPot : public CtrlBase, public Muxable, public Groupable
         */
         void process() override;
 
+        /**
+        * @brief Call the callbacks of an event held back by a two-phase pass.
+        */
+        void fireEvent(CtrlEvent::Type type, int32_t value) override;
+
         /**
         * @brief Provide an externally-read raw ADC value.
         *
@@ -139,6 +147,12 @@ class CtrlPot : public CtrlBase, public Muxable, public Groupable
     protected:
         void initialize();
         [[nodiscard]] bool isInitialized() const;
+        [[nodiscard]] uint8_t getMuxChannel() const override;
+        [[nodiscard]] uint8_t getMuxPinMode() const override;
+        [[nodiscard]] uint8_t getScanPriority() const override;
+        [[nodiscard]] bool isScanIdle(unsigned long now, unsigned long timeout) const override;
+        [[nodiscard]] bool isMuxAnalog() const override;
+        void storeMuxValue(uint16_t value) override;
         virtual uint16_t processInput();
         virtual void onValueChange(int value);
         void setSensitivity(float sensitivity);
@@ -0,0 +1,143 @@
+/*!
+ *  @file       CtrlShiftIn.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "CtrlShiftIn.h"
+#include "CtrlClock.h"
+
+CtrlShiftIn::CtrlShiftIn(
+    const uint8_t data,
+    const uint8_t clock,
+    const uint8_t latch,
+    const uint8_t chainLength
+) : data(data),
+    clock(clock),
+    latch(latch),
+    chainLength(chainLength == 0 ? 1 : chainLength > MAX_CHAIN_LENGTH ? MAX_CHAIN_LENGTH : chainLength)
+{
+}
+
+void CtrlShiftIn::initialize()
+{
+    if (this->initialized) return;
+    this->dataPin.attach(this->data);
+    this->clockPin.attach(this->clock);
+    this->latchPin.attach(this->latch);
+    this->dataPin.setMode(INPUT);
+    this->clockPin.setMode(OUTPUT);
+    this->latchPin.setMode(OUTPUT);
+    this->clockPin.write(LOW);
+    this->latchPin.write(HIGH);
+    this->initialized = true;
+}
+
+void CtrlShiftIn::capture()
+{
+    this->initialize();
+    // Load the parallel inputs, then shift them out: the first bit out is input H of the first chip.
+    this->latchPin.write(LOW);
+    this->latchPin.write(HIGH);
+    for (uint8_t chip = 0; chip < this->chainLength; ++chip) {
+        uint8_t inputs = 0;
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            inputs = static_cast<uint8_t>(inputs << 1 | this->dataPin.read());
+            this->clockPin.write(HIGH);
+            this->clockPin.write(LOW);
+        }
+        this->bits[chip] = inputs;
+    }
+}
+
+void CtrlShiftIn::refresh()
+{
+    const uint16_t pass = CtrlClock::getPass();
+    if (pass != 0 && pass == this->capturedPass) return;
+    this->capture();
+    this->capturedPass = pass;
+}
+
+void CtrlShiftIn::beginPass()
+{
+    this->capture();
+    this->inPass = true;
+}
+
+void CtrlShiftIn::endPass()
+{
+    this->inPass = false;
+}
+
+bool CtrlShiftIn::readInput(const uint8_t input)
+{
+    if (input >= this->getInputCount()) return false;
+    if (!this->inPass) this->refresh();
+    return bitRead(this->bits[input / 8], input % 8);
+}
+
+uint8_t CtrlShiftIn::getInputs(const uint8_t chip) const
+{
+    return chip < this->chainLength ? this->bits[chip] : 0;
+}
+
+uint16_t CtrlShiftIn::getInputCount() const
+{
+    return this->chainLength * 8;
+}
+
+bool CtrlShiftIn::readBtnSig(const uint8_t channel, uint8_t)
+{
+    return this->readInput(channel);
+}
+
+bool CtrlShiftIn::readEncClk(const uint8_t channel, uint8_t)
+{
+    return this->readInput(channel);
+}
+
+bool CtrlShiftIn::readEncDt(const uint8_t channel, uint8_t)
+{
+    return this->readInput(channel);
+}
+
+uint32_t CtrlShiftIn::readBtnBits(const uint8_t channel, const uint8_t count, uint8_t)
+{
+    const uint16_t inputCount = this->getInputCount();
+    if (channel >= inputCount || count == 0) return 0;
+    if (!this->inPass) this->refresh();
+    // The captured bytes form one little-endian bit string: gather the (up to) 5 bytes that hold the run.
+    const uint8_t offset = channel % 8;
+    uint32_t levels = this->bits[channel / 8] >> offset;
+    for (uint8_t chip = channel / 8 + 1, shift = 8 - offset; chip < this->chainLength && shift < 32; ++chip, shift += 8) {
+        levels |= static_cast<uint32_t>(this->bits[chip]) << shift;
+    }
+    return count >= 32 ? levels : levels & ((1ul << count) - 1);
+}
+
+uint16_t CtrlShiftIn::readPotSig(uint8_t, uint8_t)
+{
+    return 0;
+}
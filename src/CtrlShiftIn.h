@@ -0,0 +1,132 @@
+/*!
+ *  @file       CtrlShiftIn.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef CTRLSHIFTIN_H
+#define CTRLSHIFTIN_H
+
+#include <Arduino.h>
+#include "CtrlPinIO.h"
+#include "CtrlSource.h"
+
+/*
+ * A chain of parallel-in/serial-out shift registers (74HC165, CD4021, ...).
+ *
+ * Buttons and rotary encoders read their inputs from the chain the same way
+ * they would from a multiplexer, with the input number as channel. The whole
+ * chain is captured once at the start of every process() pass, and all
+ * objects decode from the captured bits without any further I/O.
+ */
+class CtrlShiftIn : public CtrlSource
+{
+    public:
+        static constexpr uint8_t MAX_CHAIN_LENGTH = 32; // 256 inputs, the range of a channel.
+
+    protected:
+        uint8_t data;
+        uint8_t clock;
+        uint8_t latch;
+        uint8_t chainLength;
+        CtrlPin dataPin;
+        CtrlPin clockPin;
+        CtrlPin latchPin;
+        uint8_t bits[MAX_CHAIN_LENGTH] = {}; // One byte per chip, input n is bit n % 8 of byte n / 8.
+        bool inPass = false;
+        uint16_t capturedPass = 0; // The CtrlClock pass of the last capture outside beginPass().
+        bool initialized = false;
+
+        void initialize();
+
+        /**
+        * @brief Capture the chain for a read outside process(), once per CtrlClock pass.
+        */
+        void refresh();
+
+        void beginPass() override;
+
+        void endPass() override;
+
+        bool readInput(uint8_t input);
+
+    public:
+        /**
+        * @brief Instantiate a shift register chain object.
+        *
+        * The CtrlShiftIn class can be instantiated to allow buttons &
+        * rotary encoders to be read through 74HC165 shift registers.
+        *
+        * Inputs are numbered from the chip nearest to the microcontroller (the
+        * one with its serial output wired to the data pin): inputs 0 - 7 are
+        * the A - H inputs of the first chip, 8 - 15 those of the second, ...
+        *
+        * @param data (uint8_t) The data pin, wired to the serial output (QH) of the first chip.
+        * @param clock (uint8_t) The clock pin, wired to the clock (CP) of all chips.
+        * @param latch (uint8_t) The latch pin, wired to the parallel load (PL) of all chips.
+        * @param chainLength (uint8_t) (optional) The number of chips in the chain. Default is 1.
+        * @return A new instance of the CtrlShiftIn class.
+        */
+        CtrlShiftIn(
+            uint8_t data,
+            uint8_t clock,
+            uint8_t latch,
+            uint8_t chainLength = 1
+        );
+
+        /**
+        * @brief Capture all inputs of the chain.
+        *
+        * Called at the start of every process() pass. Objects that are
+        * processed elsewhere (e.g. in a CtrlGroup) capture the chain once per
+        * pass of the group, or on each read when processed on their own.
+        */
+        void capture();
+
+        /**
+        * @brief The captured inputs of a chip.
+        *
+        * @param chip (uint8_t) The position of the chip in the chain.
+        * @return The inputs (bit 0 is input A, bit 7 is input H).
+        */
+        [[nodiscard]] uint8_t getInputs(uint8_t chip) const;
+
+        /**
+        * @brief The number of inputs of the chain.
+        */
+        [[nodiscard]] uint16_t getInputCount() const;
+
+        [[nodiscard]] bool readBtnSig(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] bool readEncClk(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] bool readEncDt(uint8_t channel, uint8_t pinModeType) override;
+
+        /**
+        * @brief Shift registers are digital only: potentiometers always read 0.
+        */
+        [[nodiscard]] uint16_t readPotSig(uint8_t channel, uint8_t pinModeType) override;
+        [[nodiscard]] uint32_t readBtnBits(uint8_t channel, uint8_t count, uint8_t pinModeType) override;
+};
+
+#endif // CTRLSHIFTIN_H
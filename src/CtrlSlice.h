@@ -0,0 +1,236 @@
+/*!
+ *  @file       CtrlSlice.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLSLICE_H
+#define CTRLSLICE_H
+
+#include <Arduino.h>
+#include "CtrlBase.h"
+#include "CtrlClock.h"
+
+/*
+ * Round-robin position of a multiplexer or group between time slices.
+ *
+ * The objects of a container are kept partitioned: the high priority objects
+ * first (slots [0, highCount)), followed by all others.
+ */
+struct CtrlSliceCursor
+{
+    size_t highIndex = 0; // Next high priority object.
+    size_t nextIndex = 0; // Next normal/low priority object.
+    uint8_t round = 0; // Completed rounds over the normal/low priority objects.
+};
+
+/*
+ * Adaptive scan rate of a multiplexer or group.
+ *
+ * Objects whose input did not change for timeout milliseconds are idle, and
+ * only serviced on one out of interval visits. The first change seen on such
+ * a visit makes them active again. A timeout of 0 disables this.
+ */
+struct CtrlIdleScan
+{
+    unsigned long timeout = 0;
+    uint8_t interval = 8;
+    uint8_t round = 0; // Rotates which idle objects get their turn.
+};
+
+/*
+ * The objects serviced by one process(count) call.
+ *
+ * High priority objects are serviced on every slice. The remaining slots go
+ * round-robin to the others, where low priority objects are only serviced
+ * every CtrlBase::LOW_PRIORITY_INTERVAL rounds. A slice services at most count
+ * objects, and visits (skips) every other object at most once.
+ *
+ * The cursor is advanced before an object is returned, so objects may be
+ * added or removed while the returned object is processed.
+ */
+template <typename T>
+class CtrlSlice
+{
+    protected:
+        size_t budget; // Objects still to service.
+        size_t highLeft; // High priority objects still to service.
+        size_t visitsLeft; // Normal/low priority objects still to visit.
+        bool all;
+        unsigned long idleNow = 0;
+        unsigned long idleTimeout = 0; // 0: no idle objects.
+        uint8_t idleInterval = 1;
+        uint8_t idleRound = 0;
+        bool dirtyOnly = false;
+
+    public:
+        /**
+        * @param count The number of objects to service, 0 for all of them.
+        */
+        CtrlSlice(const size_t count, const size_t objectCount, const size_t highCount)
+            : budget(count == 0 || count > objectCount ? objectCount : count),
+              highLeft(0),
+              visitsLeft(objectCount - highCount),
+              all(count == 0)
+        {
+            this->highLeft = highCount < this->budget ? highCount : this->budget;
+            // Keep a slot for the others, unless the slice only has room for one object.
+            if (!this->all && this->highLeft == this->budget && this->budget > 1 && this->visitsLeft > 0) {
+                --this->highLeft;
+            }
+        }
+
+        /**
+        * @brief Skip most visits of idle normal/low priority objects.
+        *
+        * Reads the clock once, and moves on the idle round of the container.
+        */
+        void setIdleScan(CtrlIdleScan& idle)
+        {
+            if (idle.timeout == 0 || idle.interval <= 1) return;
+            this->idleNow = CtrlClock::now();
+            this->idleTimeout = idle.timeout;
+            this->idleInterval = idle.interval;
+            this->idleRound = idle.round++;
+        }
+
+        /**
+        * @brief Skip the objects that report they have nothing to process.
+        *
+        * E.g. objects that are told about input changes by pin interrupts.
+        */
+        void setDirtyScan()
+        {
+            this->dirtyOnly = true;
+        }
+
+        T* next(T* const* objects, const size_t objectCount, size_t highCount, CtrlSliceCursor& cursor)
+        {
+            if (highCount > objectCount) highCount = objectCount;
+            if (this->budget == 0) return nullptr;
+            while (this->highLeft > 0 && highCount > 0) {
+                --this->highLeft;
+                if (cursor.highIndex >= highCount) cursor.highIndex = 0;
+                T* object = objects[cursor.highIndex];
+                cursor.highIndex = cursor.highIndex + 1 >= highCount ? 0 : cursor.highIndex + 1;
+                if (this->dirtyOnly && !object->needsProcessing()) continue;
+                --this->budget;
+                return object;
+            }
+            while (this->visitsLeft > 0 && highCount < objectCount) {
+                --this->visitsLeft;
+                if (cursor.nextIndex < highCount || cursor.nextIndex >= objectCount) cursor.nextIndex = highCount;
+                T* object = objects[cursor.nextIndex];
+                const bool lowTurn = cursor.round % CtrlBase::LOW_PRIORITY_INTERVAL == 0;
+                // Idle objects take turns, spread over the rounds by their slot.
+                const bool idleTurn = (this->idleRound + cursor.nextIndex) % this->idleInterval == 0;
+                if (++cursor.nextIndex >= objectCount) {
+                    cursor.nextIndex = highCount;
+                    ++cursor.round;
+                }
+                if (!this->all && !lowTurn && object->getScanPriority() == CtrlBase::PRIORITY_LOW) continue;
+                if (!idleTurn && this->idleTimeout > 0 && object->isScanIdle(this->idleNow, this->idleTimeout)) continue;
+                if (this->dirtyOnly && !object->needsProcessing()) continue;
+                --this->budget;
+                return object;
+            }
+            return nullptr;
+        }
+
+        /**
+        * @brief The object next() would return, without moving on.
+        */
+        T* peek(T* const* objects, const size_t objectCount, const size_t highCount, CtrlSliceCursor cursor) const
+        {
+            CtrlSlice<T> slice = *this;
+            return slice.next(objects, objectCount, highCount, cursor);
+        }
+};
+
+/**
+* @brief Update the running estimate of the time an object takes to process.
+*
+* An exponential moving average (1/4 weight for the new measurement), so a
+* single slow call (e.g. a callback doing more work) does not stall the next slices.
+*
+* @param cost The estimate in microseconds, 0 when unknown.
+* @param measured The measured time in microseconds.
+*/
+inline void ctrlUpdateCost(uint16_t& cost, uint32_t measured)
+{
+    if (measured > UINT16_MAX) measured = UINT16_MAX;
+    cost = cost == 0 ? static_cast<uint16_t>(measured) : static_cast<uint16_t>((3ul * cost + measured + 3) / 4);
+}
+
+/*
+ * Tunes a processing time budget to hold a target loop period.
+ *
+ * Every call measures the time since the previous call (the loop period) and
+ * moves the budget by half of the difference with the target.
+ */
+struct CtrlLoopTuner
+{
+    uint32_t budget = 0;
+    uint32_t lastCall = 0;
+    bool started = false;
+
+    uint32_t update(const uint32_t period, const uint32_t now)
+    {
+        if (!this->started) {
+            this->started = true;
+            this->budget = period / 2;
+        } else {
+            const uint32_t measured = now - this->lastCall;
+            if (measured > period) {
+                const uint32_t excess = (measured - period) / 2;
+                this->budget = excess >= this->budget ? 0 : this->budget - excess;
+            } else {
+                this->budget += (period - measured) / 2;
+                if (this->budget > period) this->budget = period;
+            }
+        }
+        this->lastCall = now;
+        return this->budget;
+    }
+};
+
+/**
+* @brief Move the high priority objects to the front, keeping their order.
+*
+* @return The number of high priority objects.
+*/
+template <typename T>
+size_t ctrlPartitionByPriority(T** objects, const size_t objectCount)
+{
+    size_t highCount = 0;
+    for (size_t i = 0; i < objectCount; ++i) {
+        T* object = objects[i];
+        if (object->getScanPriority() != CtrlBase::PRIORITY_HIGH) continue;
+        for (size_t j = i; j > highCount; --j) objects[j] = objects[j - 1];
+        objects[highCount++] = object;
+    }
+    return highCount;
+}
+
+#endif // CTRLSLICE_H
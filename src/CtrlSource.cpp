@@ -0,0 +1,248 @@
+/*!
+ *  @file       CtrlSource.cpp
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <new>
+#include "CtrlSource.h"
+#include "Muxable.h"
+
+CtrlSource::CtrlSource(
+    Muxable** storage,
+    const size_t capacity
+) : objects(storage),
+    capacity(capacity),
+    fixedStorage(true)
+{
+}
+
+CtrlSource::~CtrlSource() {
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        this->objects[i]->mux = nullptr;
+        this->objects[i]->muxed = false;
+        this->objects[i]->muxIndex = SIZE_MAX;
+    }
+    if (!this->fixedStorage) delete[] this->objects;
+    delete this->deferredEvents;
+}
+
+void CtrlSource::beginPass()
+{
+}
+
+void CtrlSource::endPass()
+{
+}
+
+void CtrlSource::buildScanPlan()
+{
+    this->highCount = ctrlPartitionByPriority(this->objects, this->objectCount);
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        this->objects[i]->muxIndex = i;
+    }
+}
+
+void CtrlSource::refreshScanPlan()
+{
+}
+
+void CtrlSource::updateScanPlan()
+{
+    if (this->priorityVersion != CtrlBase::priorityVersion) this->scanPlanDirty = true;
+    if (this->scanPlanDirty) {
+        this->scanPlanDirty = false;
+        this->priorityVersion = CtrlBase::priorityVersion;
+        this->buildScanPlan();
+    } else if (!this->scanPlanStale) {
+        return;
+    }
+    this->scanPlanStale = false;
+    this->refreshScanPlan();
+}
+
+bool CtrlSource::addObject(Muxable* object) {
+    if (this->contains(object)) return true;
+    if (this->objectCount == this->capacity) {
+        resize();
+        if (this->objectCount == this->capacity) return false;
+    }
+    object->muxIndex = this->objectCount;
+    this->objects[this->objectCount++] = object;
+    object->mux = this;
+    object->muxed = true;
+    this->scanPlanDirty = true;
+    return true;
+}
+
+void CtrlSource::removeObject(Muxable* object) {
+    if (!this->contains(object)) return;
+    const size_t i = object->muxIndex;
+    object->mux = nullptr;
+    object->muxed = false;
+    object->muxIndex = SIZE_MAX;
+    const size_t last = --this->objectCount;
+    size_t slot = i;
+    // Swap-remove within the priority partition: a gap among the high priority
+    // objects is filled by the last of them, which moves the gap to the start
+    // of the others, where it is filled by the last object.
+    if (i < this->highCount) {
+        slot = --this->highCount;
+        this->fillSlot(i, slot, this->cursor.highIndex);
+        if (this->cursor.highIndex >= this->highCount) this->cursor.highIndex = 0;
+    }
+    this->fillSlot(slot, last, this->cursor.nextIndex);
+    if (this->cursor.nextIndex >= this->objectCount || this->cursor.nextIndex < this->highCount) {
+        this->cursor.nextIndex = this->highCount < this->objectCount ? this->highCount : 0;
+    }
+    this->scanPlanStale = true;
+}
+
+void CtrlSource::fillSlot(const size_t slot, const size_t last, size_t& next) {
+    // Objects before next were already processed this round, so the gap is
+    // filled such that the ones still waiting stay at or after it.
+    if (slot < next && next <= last) {
+        this->moveObject(next - 1, slot);
+        this->moveObject(last, next - 1);
+        --next;
+    } else {
+        this->moveObject(last, slot);
+    }
+}
+
+bool CtrlSource::contains(const Muxable* object) const {
+    return object->muxIndex < this->objectCount && this->objects[object->muxIndex] == object;
+}
+
+void CtrlSource::moveObject(const size_t from, const size_t to) {
+    if (from == to) return;
+    this->objects[to] = this->objects[from];
+    this->objects[to]->muxIndex = to;
+}
+
+void CtrlSource::process(const uint8_t count)
+{
+    if (this->objectCount == 0) return;
+    const CtrlClock::Pass pass; // All objects of the pass share one timestamp.
+    const CtrlDeferredEvents::Phase phase(this->deferredEvents); // Fires the held back events on return.
+    this->beginPass();
+    this->updateScanPlan();
+    // A full pass does not move the round-robin position.
+    CtrlSliceCursor fullPass;
+    CtrlSliceCursor& cursor = count == 0 ? fullPass : this->cursor;
+    CtrlSlice<Muxable> slice(count, this->objectCount, this->highCount);
+    slice.setIdleScan(this->idleScan);
+    while (Muxable* object = slice.next(this->objects, this->objectCount, this->highCount, cursor)) {
+        object->process();
+        if (this->objectCount == 0) break;
+    }
+    this->endPass();
+}
+
+size_t CtrlSource::processFor(const uint32_t budget)
+{
+    if (this->objectCount == 0) return 0;
+    const CtrlClock::Pass pass; // All objects of the pass share one timestamp.
+    const CtrlDeferredEvents::Phase phase(this->deferredEvents); // Fires the held back events on return.
+    this->beginPass();
+    this->updateScanPlan();
+    const uint32_t start = CtrlClock::nowMicros();
+    CtrlSlice<Muxable> slice(this->objectCount, this->objectCount, this->highCount);
+    slice.setIdleScan(this->idleScan);
+    size_t processed = 0;
+    while (Muxable* object = slice.peek(this->objects, this->objectCount, this->highCount, this->cursor)) {
+        if (processed > 0 && static_cast<uint32_t>(CtrlClock::nowMicros() - start) + object->muxCost > budget) break;
+        slice.next(this->objects, this->objectCount, this->highCount, this->cursor);
+        const uint32_t before = CtrlClock::nowMicros();
+        object->process();
+        ctrlUpdateCost(object->muxCost, CtrlClock::nowMicros() - before);
+        ++processed;
+        if (this->objectCount == 0) break;
+    }
+    this->endPass();
+    return processed;
+}
+
+size_t CtrlSource::processForPeriod(const uint32_t period)
+{
+    return this->processFor(this->loopTuner.update(period, CtrlClock::nowMicros()));
+}
+
+void CtrlSource::setIdleScan(const unsigned long timeout, const uint8_t interval)
+{
+    this->idleScan.timeout = timeout;
+    this->idleScan.interval = interval;
+}
+
+bool CtrlSource::setTwoPhaseScan(const bool enabled, const uint8_t capacity)
+{
+    // Not from a callback of a two-phase pass: its events are still in use.
+    if (this->deferredEvents != nullptr && this->deferredEvents->isInUse()) return false;
+    delete this->deferredEvents;
+    this->deferredEvents = nullptr;
+    if (!enabled) return true;
+    auto* events = new (std::nothrow) CtrlDeferredEvents(capacity);
+    if (events == nullptr || events->getCapacity() == 0) {
+        delete events;
+        return false;
+    }
+    this->deferredEvents = events;
+    return true;
+}
+
+void CtrlSource::reserve(const size_t capacity) {
+    if (this->fixedStorage || capacity <= this->capacity) return;
+    auto** newObjects = new (std::nothrow) Muxable*[capacity];
+    if (newObjects == nullptr) return;
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        newObjects[i] = this->objects[i];
+    }
+    delete[] this->objects;
+    this->objects = newObjects;
+    this->capacity = capacity;
+}
+
+void CtrlSource::resize() {
+    if (this->fixedStorage) return;
+    const size_t newCapacity = this->capacity == 0 ? 4 : this->capacity * 2;
+    if (newCapacity <= this->capacity) return;
+    auto** newObjects = new (std::nothrow) Muxable*[newCapacity];
+    if (newObjects == nullptr) return;
+    for (size_t i = 0; i < this->objectCount; ++i) {
+        newObjects[i] = this->objects[i];
+    }
+    delete[] this->objects;
+    this->objects = newObjects;
+    this->capacity = newCapacity;
+}
+
+uint32_t CtrlSource::readBtnBits(const uint8_t channel, const uint8_t count, const uint8_t pinModeType)
+{
+    uint32_t levels = 0;
+    for (uint8_t i = 0; i < count && i < 32; ++i) {
+        if (this->readBtnSig(static_cast<uint8_t>(channel + i), pinModeType)) levels |= 1ul << i;
+    }
+    return levels;
+}
@@ -0,0 +1,238 @@
+/*!
+ *  @file       CtrlSource.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CTRLSOURCE_H
+#define CTRLSOURCE_H
+
+#include <Arduino.h>
+#include "CtrlSlice.h"
+
+class Muxable;
+
+/*
+ * Base class of everything buttons, rotary encoders & potentiometers can read
+ * their inputs from, instead of their own pins: multiplexers (CtrlMux),
+ * shift registers (CtrlShiftIn), ...
+ *
+ * It keeps track of the attached (Muxable) objects and schedules their
+ * processing. Derived classes provide the reads, and may capture all their
+ * inputs at the start of a pass (beginPass).
+ */
+class CtrlSource
+{
+    protected:
+        Muxable** objects = nullptr;
+        size_t objectCount = 0;
+        size_t capacity = 0;
+        bool fixedStorage = false; // The objects array is not owned, e.g. by a CtrlMuxT.
+        CtrlSliceCursor cursor;
+        size_t highCount = 0; // The high priority objects come first in the scan plan.
+        uint16_t priorityVersion = 0;
+        bool scanPlanDirty = false;
+        bool scanPlanStale = false; // Only what is derived from the objects is out of date, e.g. after a removal.
+        CtrlLoopTuner loopTuner;
+        CtrlIdleScan idleScan;
+        CtrlDeferredEvents* deferredEvents = nullptr; // Only with a two-phase scan.
+
+        CtrlSource() = default;
+
+        /**
+        * @brief Instantiate a source with fixed object storage.
+        *
+        * The storage is never reallocated nor deleted.
+        */
+        CtrlSource(Muxable** storage, size_t capacity);
+
+        /**
+        * @brief Called before the objects are processed, e.g. to capture all inputs.
+        */
+        virtual void beginPass();
+
+        /**
+        * @brief Called after the objects are processed.
+        */
+        virtual void endPass();
+
+        /**
+        * @brief Reorder the objects into a scan plan.
+        *
+        * Must put the high priority objects first and set highCount. The default
+        * only does that, keeping the order of the objects otherwise.
+        */
+        virtual void buildScanPlan();
+
+        /**
+        * @brief Update what is derived from the objects, e.g. the channels in use.
+        *
+        * Called after buildScanPlan(), and on its own after a removal, which
+        * keeps the order of the scan plan. The default does nothing.
+        */
+        virtual void refreshScanPlan();
+
+        /**
+        * @brief Rebuild the scan plan if objects were added or priorities changed.
+        */
+        void updateScanPlan();
+
+    public:
+        virtual ~CtrlSource();
+
+        CtrlSource(const CtrlSource&) = delete;
+        CtrlSource& operator=(const CtrlSource&) = delete;
+        CtrlSource(CtrlSource&&) = delete;
+        CtrlSource& operator=(CtrlSource&&) = delete;
+
+        /**
+        * @brief Add an object to the source.
+        *
+        * @param object Object to be added to the source.
+        */
+        bool addObject(Muxable* object);
+
+        /**
+        * @brief Remove an object from the source.
+        *
+        * Adding and removing objects takes constant time: objects know their
+        * slot, and the last object of the same priority fills the gap of a
+        * removed one, so the scan plan stays valid without a rebuild.
+        *
+        * @param object Object to be removed from the source.
+        */
+        void removeObject(Muxable* object);
+
+        /**
+        * @brief Pre-allocate capacity for a known number of objects.
+        *
+        * Call this before adding objects to avoid heap allocations during runtime.
+        * Has no effect on sources with fixed storage.
+        *
+        * @param capacity The number of objects to pre-allocate space for.
+        */
+        void reserve(size_t capacity);
+
+        /**
+        * @brief The process method should be called within the loop method.
+        * It handles the functionality of all added objects.
+        *
+        * @param count (optional) The number of objects to process per call.
+        * When 0 (default), all objects are processed. When > 0, objects are
+        * processed in round-robin order for time-sliced, real-time-safe control
+        * processing. Use this to bound the worst-case execution time per loop
+        * iteration.
+        *
+        * With count > 0, objects with CtrlBase::PRIORITY_HIGH (e.g. encoders)
+        * are serviced on every call, the remaining slots go round-robin to the
+        * others, where PRIORITY_LOW objects (e.g. potentiometers) only get a turn
+        * every CtrlBase::LOW_PRIORITY_INTERVAL rounds. Never more than count
+        * objects are processed per call. Keep count larger than the number of
+        * high priority objects: at least one slot is kept for the others, but
+        * the high priority objects then take turns.
+        */
+        virtual void process(uint8_t count = 0);
+
+        /**
+        * @brief Process objects in round-robin order within a time budget.
+        *
+        * A running estimate of the time each object takes to process is kept.
+        * Objects are processed (in the same order, and with the same priorities
+        * as process(count)) until the next one would exceed the budget. At least
+        * one object, and every object at most once, is processed per call.
+        *
+        * @param budget (uint32_t) The time budget in microseconds.
+        * @return The number of objects processed.
+        */
+        size_t processFor(uint32_t budget);
+
+        /**
+        * @brief Process objects within a budget that is tuned to hold a loop period.
+        *
+        * Call this once per loop. The time between calls is measured, and the
+        * budget of processFor() grows or shrinks until the loop takes the
+        * given period, e.g. to leave a fixed share of the loop to audio code.
+        *
+        * @param period (uint32_t) The target loop period in microseconds.
+        * @return The number of objects processed.
+        */
+        size_t processForPeriod(uint32_t period);
+
+        /**
+        * @brief Scan objects that are not being touched at a lower rate.
+        *
+        * An object whose input did not change (a button not pressed or
+        * released, an encoder not turned, a potentiometer not moved) for
+        * timeout milliseconds is only processed on 1 out of interval turns,
+        * leaving more time for the controls in use. As soon as such a turn
+        * sees a change, the object is processed on every turn again. High
+        * priority objects are always processed on every turn.
+        *
+        * @param timeout (unsigned long) Milliseconds without input change before an object is idle, 0 (default) to disable.
+        * @param interval (uint8_t) (optional) Idle objects are processed on 1 out of interval turns. Default is 8.
+        */
+        void setIdleScan(unsigned long timeout, uint8_t interval = 8);
+
+        /**
+        * @brief Sample all objects first, then fire their events.
+        *
+        * In the first phase of a pass all objects are sampled & decoded while
+        * their events (group chords included) are held back, so no callback
+        * runs while sampling. In the second phase the events fire in
+        * the order they happened. A slow callback then no longer delays the
+        * sampling of the objects after it, and buttons pressed together are
+        * all seen pressed before any callback runs.
+        *
+        * @param enabled (bool) Enable or disable the two-phase scan.
+        * @param capacity (uint8_t) (optional) The number of events held back per pass, more fire right away. Default is 16.
+        * @return false when there is no memory for the events.
+        */
+        bool setTwoPhaseScan(bool enabled, uint8_t capacity = 16);
+
+        [[nodiscard]] virtual bool readBtnSig(uint8_t channel, uint8_t pinModeType) = 0;
+        [[nodiscard]] virtual bool readEncClk(uint8_t channel, uint8_t pinModeType) = 0;
+        [[nodiscard]] virtual bool readEncDt(uint8_t channel, uint8_t pinModeType) = 0;
+        [[nodiscard]] virtual uint16_t readPotSig(uint8_t channel, uint8_t pinModeType) = 0;
+
+        /**
+        * @brief Read a run of consecutive channels as buttons, e.g. for a CtrlBtnBank.
+        *
+        * The default reads the channels one by one. Sources that capture all
+        * their inputs at once return them straight from the capture.
+        *
+        * @param channel (uint8_t) The first channel.
+        * @param count (uint8_t) The number of channels, at most 32.
+        * @param pinModeType (uint8_t) The pin mode of the channels.
+        * @return The levels, bit 0 is the first channel.
+        */
+        [[nodiscard]] virtual uint32_t readBtnBits(uint8_t channel, uint8_t count, uint8_t pinModeType);
+
+    protected:
+        bool contains(const Muxable* object) const;
+        void moveObject(size_t from, size_t to);
+        void fillSlot(size_t slot, size_t last, size_t& next);
+        void resize();
+};
+
+#endif // CTRLSOURCE_H
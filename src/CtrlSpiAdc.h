@@ -0,0 +1,320 @@
+/*!
+ *  @file       CtrlSpiAdc.h
+ *  Project     Arduino CTRL Library
+ *  @brief      CTRL Library for interfacing with common controls
+ *  @author     Johannes Jan Prins
+ *  @date       08/05/2024
+ *  @license    MIT - Copyright (c) 2024 Johannes Jan Prins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef CTRLSPIADC_H
+#define CTRLSPIADC_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "CtrlBase.h"
+#include "CtrlPinIO.h"
+#include "CtrlSource.h"
+#include "Muxable.h"
+
+/*
+ * An external SPI ADC (MCP3008, MCP3208 or ADS7953).
+ *
+ * Potentiometers read their inputs from the ADC the same way they would from a
+ * multiplexer, with the ADC channel as channel. All channels read by the
+ * objects are converted in one burst (a single SPI transaction) at the start
+ * of every process() pass, and the objects smooth the converted values.
+ *
+ * Conversions can also run from a timer ISR: disable the automatic conversion
+ * (setAutoConvert(false)) and call convert() from the ISR. Each potentiometer
+ * then gets its value through storeRaw(), and process() only does the
+ * smoothing and the callbacks. The ISR walks a snapshot of the potentiometers,
+ * swapped in by process(), never the objects being reordered by the scan plan.
+ *
+ * Kept header only (and out of CTRL.h), so sketches that do not use it do not
+ * depend on the SPI library. Call SPI.begin() in setup().
+ */
+class CtrlSpiAdc : public CtrlSource
+{
+    public:
+        static constexpr uint8_t MAX_ISR_OBJECTS = 16; // Potentiometers fed by convert() from a timer ISR.
+
+        enum Chip : uint8_t {
+            MCP3008, // 8 channels, 10 bit.
+            MCP3208, // 8 channels, 12 bit.
+            ADS7953 // 16 channels, 12 bit.
+        };
+
+    protected:
+        SPIClass& spi;
+        SPISettings settings;
+        Chip chip;
+        uint8_t cs;
+        CtrlPin csPin;
+        volatile uint16_t values[16] = {};
+        volatile uint16_t channels = 0; // Bitmask of the channels read by the objects.
+        struct IsrTarget
+        {
+            Muxable* object;
+            uint8_t channel;
+        };
+        IsrTarget isrTargets[2][MAX_ISR_OBJECTS] = {}; // Double buffered: one is read by the ISR, the other rebuilt.
+        uint8_t isrCounts[2] = {};
+        volatile uint8_t isrSnapshot = 0; // The buffer convert() reads.
+        bool autoConvert = true;
+        bool initialized = false;
+
+        static uint32_t defaultClock(const Chip chip)
+        {
+            // The maximum clock at 2.7 V (MCP3x08), or at any supply (ADS7953).
+            return chip == ADS7953 ? 20000000 : chip == MCP3208 ? 1000000 : 1350000;
+        }
+
+        void initialize()
+        {
+            if (this->initialized) return;
+            this->csPin.attach(this->cs);
+            this->csPin.setMode(OUTPUT);
+            this->csPin.write(HIGH);
+            this->initialized = true;
+        }
+
+        void beginPass() override
+        {
+            this->updateScanPlan();
+            if (this->autoConvert) this->convert();
+        }
+
+        /**
+        * @brief Collect the channels to convert, and the potentiometers the ISR feeds.
+        */
+        void refreshScanPlan() override
+        {
+            uint16_t channels = 0;
+            const uint8_t next = this->isrSnapshot ^ 1;
+            uint8_t count = 0;
+            for (size_t i = 0; i < this->objectCount; ++i) {
+                Muxable* object = this->objects[i];
+                channels |= object->getMuxChannelMask();
+                const uint8_t channel = object->getMuxChannel();
+                if (!object->isMuxAnalog() || channel >= 16 || count == MAX_ISR_OBJECTS) continue;
+                this->isrTargets[next][count++] = { object, channel };
+            }
+            this->isrCounts[next] = count;
+            const auto irqState = ctrlSaveInterrupts();
+            this->channels = channels & this->getChannelMask();
+            this->isrSnapshot = next;
+            ctrlRestoreInterrupts(irqState);
+        }
+
+        uint16_t getChannelMask() const
+        {
+            return this->chip == ADS7953 ? 0xffff : 0x00ff;
+        }
+
+        /**
+        * @brief Convert a channel of a MCP3008 / MCP3208, one conversion per frame.
+        */
+        uint16_t convertMcp(const uint8_t channel)
+        {
+            uint8_t frame[3];
+            if (this->chip == MCP3008) {
+                // Start bit, single-ended, channel: the 10 bit result ends in the last 2 bytes.
+                frame[0] = 0x01;
+                frame[1] = static_cast<uint8_t>(0x80 | channel << 4);
+            } else {
+                // Start bit & single-ended in the first byte, aligning the 12 bit result the same way.
+                frame[0] = static_cast<uint8_t>(0x06 | channel >> 2);
+                frame[1] = static_cast<uint8_t>(channel << 6);
+            }
+            frame[2] = 0;
+            this->csPin.write(LOW);
+            this->spi.transfer(frame, sizeof(frame));
+            this->csPin.write(HIGH);
+            const uint8_t mask = this->chip == MCP3008 ? 0x03 : 0x0f;
+            return static_cast<uint16_t>((frame[1] & mask) << 8 | frame[2]);
+        }
+
+        /**
+        * @brief Transfer one 16 bit frame of an ADS7953.
+        */
+        uint16_t transferAds(const uint16_t command)
+        {
+            uint8_t frame[2] = { static_cast<uint8_t>(command >> 8), static_cast<uint8_t>(command & 0xff) };
+            this->csPin.write(LOW);
+            this->spi.transfer(frame, sizeof(frame));
+            this->csPin.write(HIGH);
+            return static_cast<uint16_t>(frame[0] << 8 | frame[1]);
+        }
+
+        /**
+        * @brief Convert the channels of an ADS7953 in manual mode.
+        *
+        * The channel programmed in a frame is output two frames later, tagged
+        * with its channel number: the burst ends with two extra frames.
+        */
+        void convertAds(const uint16_t channels)
+        {
+            uint8_t frames = 0;
+            uint16_t command = 0;
+            for (uint8_t channel = 0; channel < 16; ++channel) {
+                if (!bitRead(channels, channel)) continue;
+                // Manual mode, program the channel, range 1 (0 - Vref).
+                command = static_cast<uint16_t>(0x1800 | channel << 7);
+                this->storeAds(this->transferAds(command), frames++);
+            }
+            this->storeAds(this->transferAds(command), frames++);
+            this->storeAds(this->transferAds(command), frames);
+        }
+
+        void storeAds(const uint16_t result, const uint8_t frame)
+        {
+            // The first two results belong to the previous burst.
+            if (frame < 2) return;
+            this->values[result >> 12] = result & 0x0fff;
+        }
+
+    public:
+        /**
+        * @brief Instantiate a SPI ADC object.
+        *
+        * @param cs (uint8_t) The chip select (CS) pin.
+        * @param chip (Chip) (optional) CtrlSpiAdc::MCP3008 (default), CtrlSpiAdc::MCP3208 or CtrlSpiAdc::ADS7953.
+        * @param spi (SPIClass) (optional) The SPI bus. Default is SPI.
+        * @param clock (uint32_t) (optional) The SPI clock in Hz. Default is 0, the maximum
+        * clock of the chip at its lowest supply voltage.
+        * @return A new instance of the CtrlSpiAdc class.
+        */
+        explicit CtrlSpiAdc(
+            const uint8_t cs,
+            const Chip chip = MCP3008,
+            SPIClass& spi = SPI,
+            const uint32_t clock = 0
+        ) : spi(spi),
+            settings(clock == 0 ? defaultClock(chip) : clock, MSBFIRST, SPI_MODE0),
+            chip(chip),
+            cs(cs)
+        {
+        }
+
+        /**
+        * @brief Convert all channels read by the objects in one burst.
+        *
+        * Called at the start of every process() pass, unless automatic
+        * conversion is disabled. Can be called from a timer ISR: add all
+        * objects, and call process() once, before the timer is started.
+        * Until then, all channels are converted. Objects that are processed
+        * elsewhere (e.g. in a CtrlGroup) use the values of the last conversion.
+        *
+        * The ISR feeds the potentiometers of the last process() (up to
+        * MAX_ISR_OBJECTS), so stop the timer before destroying one.
+        */
+        void convert()
+        {
+            this->initialize();
+            uint16_t channels = this->channels;
+            if (channels == 0) channels = this->getChannelMask();
+
+            this->spi.beginTransaction(this->settings);
+            if (this->chip == ADS7953) {
+                this->convertAds(channels);
+            } else {
+                for (uint8_t channel = 0; channel < 8; ++channel) {
+                    if (bitRead(channels, channel)) this->values[channel] = this->convertMcp(channel);
+                }
+            }
+            this->spi.endTransaction();
+
+            if (this->autoConvert) return;
+            const uint8_t snapshot = this->isrSnapshot;
+            for (uint8_t i = 0; i < this->isrCounts[snapshot]; ++i) {
+                const IsrTarget& target = this->isrTargets[snapshot][i];
+                target.object->storeMuxValue(this->values[target.channel]);
+            }
+        }
+
+        /**
+        * @brief Enable or disable the conversion at the start of every process() pass.
+        *
+        * Disable it when convert() is called from a timer ISR. This also
+        * tells the SPI library (where it supports it) to mask interrupts
+        * during the transactions of all other SPI devices, which the ISR
+        * would otherwise break into. Without that support, wrap the other
+        * SPI transactions in noInterrupts() / interrupts() yourself.
+        *
+        * @param autoConvert (bool) Convert in process() (default: true).
+        */
+        void setAutoConvert(const bool autoConvert)
+        {
+#ifdef SPI_HAS_NOTUSINGINTERRUPT
+            if (!autoConvert) this->spi.usingInterrupt(static_cast<uint8_t>(NOT_AN_INTERRUPT)); // A timer: mask all interrupts.
+#endif
+            this->autoConvert = autoConvert;
+        }
+
+        /**
+        * @brief The maximum value of a conversion.
+        *
+        * Pass it to CtrlPot::setAnalogMax() for the 12 bit chips.
+        */
+        [[nodiscard]] uint16_t getAnalogMax() const
+        {
+            return this->chip == MCP3008 ? 1023 : 4095;
+        }
+
+        /**
+        * @brief The last converted value of a channel.
+        */
+        [[nodiscard]] uint16_t getValue(const uint8_t channel) const
+        {
+            if (channel >= 16) return 0;
+            const auto irqState = ctrlSaveInterrupts();
+            const uint16_t value = this->values[channel];
+            ctrlRestoreInterrupts(irqState);
+            return value;
+        }
+
+        [[nodiscard]] uint16_t readPotSig(const uint8_t channel, uint8_t) override
+        {
+            return this->getValue(channel);
+        }
+
+        /**
+        * @brief Buttons & encoders read a channel as high above half scale.
+        */
+        [[nodiscard]] bool readBtnSig(const uint8_t channel, uint8_t) override
+        {
+            return this->getValue(channel) > this->getAnalogMax() / 2;
+        }
+
+        [[nodiscard]] bool readEncClk(const uint8_t channel, const uint8_t pinModeType) override
+        {
+            return this->readBtnSig(channel, pinModeType);
+        }
+
+        [[nodiscard]] bool readEncDt(const uint8_t channel, const uint8_t pinModeType) override
+        {
+            return this->readBtnSig(channel, pinModeType);
+        }
+};
+
+#endif // CTRLSPIADC_H
@@ -147,4 +147,19 @@ const Groupable::Property* Groupable::findProperty(const char* key) const
         }
     }
     return nullptr;
-}
\ No newline at end of file
+}
+
+uint8_t Groupable::getScanPriority() const
+{
+    return CtrlBase::PRIORITY_NORMAL;
+}
+
+bool Groupable::isScanIdle(unsigned long, unsigned long) const
+{
+    return false;
+}
+
+bool Groupable::needsProcessing() const
+{
+    return true;
+}
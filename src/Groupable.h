@@ -29,6 +29,7 @@
 #define GROUPABLE_H
 
 #include <Arduino.h>
+#include "CtrlBase.h"
 
 class CtrlGroup;
 
@@ -39,6 +40,11 @@ class Groupable
     protected:
         CtrlGroup* group = nullptr;
         bool grouped = false;
+        size_t groupIndex = SIZE_MAX; // Slot in the objects array of the group.
+        uint16_t groupCost = 0; // Running estimate of process() in microseconds, see CtrlGroup::processFor().
+        uint8_t groupBit = NO_GROUP_BIT; // Bit in the masks of the group, see CtrlGroup::getMask().
+
+        static constexpr uint8_t NO_GROUP_BIT = 0xFF;
 
         static constexpr uint8_t MAX_PROPERTIES = 8;
         static constexpr uint8_t MAX_KEY_LENGTH = 15;
@@ -130,6 +136,23 @@ class Groupable
          */
         [[nodiscard]] const char* getString(const char* key) const;
 
+        /**
+        * @brief The scan priority (CtrlBase::Priority) for time-sliced processing.
+        */
+        [[nodiscard]] virtual uint8_t getScanPriority() const;
+
+        /**
+        * @brief Whether the input did not change for timeout milliseconds, see CtrlGroup::setIdleScan().
+        */
+        [[nodiscard]] virtual bool isScanIdle(unsigned long now, unsigned long timeout) const;
+
+        /**
+        * @brief Whether process() has anything to do.
+        *
+        * Objects that are told about input changes by pin interrupts return
+        * false until an input changed, or a timeout (e.g. a debounce) is pending.
+        */
+        [[nodiscard]] virtual bool needsProcessing() const;
 
     protected:
         [[nodiscard]] Property* findProperty(const char* key);
@@ -26,10 +26,10 @@
  */
 
 #include "Muxable.h"
-#include "CtrlMux.h"
+#include "CtrlSource.h"
 
 Muxable::Muxable(
-    CtrlMux* mux
+    CtrlSource* mux
 ) {
     this->mux = mux;
     this->muxed = mux != nullptr;
@@ -53,7 +53,7 @@ bool Muxable::isMuxed() const
     return this->muxed;
 }
 
-bool Muxable::setMultiplexer(CtrlMux* mux)
+bool Muxable::setMultiplexer(CtrlSource* mux)
 {
     if (this->mux != nullptr) {
         this->mux->removeObject(this);
@@ -68,4 +68,49 @@ bool Muxable::setMultiplexer(CtrlMux* mux)
         }
     }
     return true;
-}
\ No newline at end of file
+}
+
+uint8_t Muxable::getMuxChannel() const
+{
+    return 0;
+}
+
+uint8_t Muxable::getMuxPinMode() const
+{
+    return INPUT;
+}
+
+uint16_t Muxable::getMuxChannelMask() const
+{
+    const uint8_t channel = this->getMuxChannel();
+    return channel < 16 ? static_cast<uint16_t>(1u << channel) : 0;
+}
+
+bool Muxable::getMuxIdleLevel() const
+{
+    return this->getMuxPinMode() != INPUT_PULLDOWN;
+}
+
+bool Muxable::isMuxAnalog() const
+{
+    return false;
+}
+
+void Muxable::storeMuxValue(uint16_t)
+{
+}
+
+uint8_t Muxable::getScanPriority() const
+{
+    return CtrlBase::PRIORITY_NORMAL;
+}
+
+bool Muxable::isScanIdle(unsigned long, unsigned long) const
+{
+    return false;
+}
+
+bool Muxable::needsProcessing() const
+{
+    return true;
+}
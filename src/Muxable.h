@@ -28,19 +28,28 @@
 #ifndef MUXABLE_H
 #define MUXABLE_H
 
+#include <Arduino.h>
+#include "CtrlBase.h"
+
 class CtrlMux;
+class CtrlSource;
 
 class Muxable
 {
+    friend class CtrlSource;
     friend class CtrlMux;
+    friend class CtrlExpander;
+    friend class CtrlSpiAdc;
 
     protected:
-        CtrlMux* mux = nullptr;
+        CtrlSource* mux = nullptr;
         bool muxed = false;
+        size_t muxIndex = SIZE_MAX; // Slot in the objects array of the multiplexer.
+        uint16_t muxCost = 0; // Running estimate of process() in microseconds, see CtrlSource::processFor().
 
     public:
         explicit Muxable(
-            CtrlMux* mux = nullptr
+            CtrlSource* mux = nullptr
         );
 
         virtual ~Muxable();
@@ -63,7 +72,67 @@ class Muxable
         *
         * @param mux reference to the multiplexer object.
         */
-        bool setMultiplexer(CtrlMux* mux);
+        bool setMultiplexer(CtrlSource* mux);
+
+    protected:
+        /**
+        * @brief The (first) multiplexer channel this object reads from.
+        *
+        * Used by the multiplexer to order its scan plan.
+        */
+        [[nodiscard]] virtual uint8_t getMuxChannel() const;
+
+        /**
+        * @brief The pin mode this object needs on the multiplexer signal pin.
+        *
+        * Used by the multiplexer to group objects that share a pin mode.
+        */
+        [[nodiscard]] virtual uint8_t getMuxPinMode() const;
+
+        /**
+        * @brief Bitmask of all multiplexer channels this object reads from.
+        */
+        [[nodiscard]] virtual uint16_t getMuxChannelMask() const;
+
+        /**
+        * @brief The level of this object's channels at rest (a released button).
+        *
+        * Used by sources that have no reading yet, e.g. an expander that did
+        * not answer so far. The default follows the pin mode.
+        */
+        [[nodiscard]] virtual bool getMuxIdleLevel() const;
+
+        /**
+        * @brief Whether this object reads its channels as analog inputs.
+        */
+        [[nodiscard]] virtual bool isMuxAnalog() const;
+
+        /**
+        * @brief Take a value converted outside of process(), e.g. from a timer ISR.
+        *
+        * Must be ISR safe. The default ignores it, the object then reads its
+        * channel(s) from the source while it is processed.
+        */
+        virtual void storeMuxValue(uint16_t value);
+
+    public:
+        /**
+        * @brief The scan priority (CtrlBase::Priority) for time-sliced processing.
+        */
+        [[nodiscard]] virtual uint8_t getScanPriority() const;
+
+        /**
+        * @brief Whether the input did not change for timeout milliseconds, see CtrlSource::setIdleScan().
+        */
+        [[nodiscard]] virtual bool isScanIdle(unsigned long now, unsigned long timeout) const;
+
+        /**
+        * @brief Whether process() has anything to do.
+        *
+        * Objects that are told about input changes by pin interrupts return
+        * false until an input changed, or a timeout (e.g. a debounce) is pending.
+        */
+        [[nodiscard]] virtual bool needsProcessing() const;
 };
 
 #endif //MUXABLE_H
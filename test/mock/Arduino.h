@@ -32,7 +32,15 @@ inline unsigned long& _mock_micros_ref() {
     return val;
 }
 
-inline unsigned long millis() { return _mock_millis_ref(); }
+inline unsigned long& _mock_millis_call_count() {
+    static unsigned long val = 0;
+    return val;
+}
+
+inline unsigned long millis() {
+    ++_mock_millis_call_count();
+    return _mock_millis_ref();
+}
 inline unsigned long micros() { return _mock_micros_ref()++; }
 
 inline void delay(unsigned long ms) {
@@ -77,7 +85,19 @@ inline void _mock_set_digital_sequence(uint8_t pin, const int* vals, uint8_t len
     seq.index = 0;
 }
 
+inline unsigned long& _mock_digital_write_count() {
+    static unsigned long val = 0;
+    return val;
+}
+
+inline unsigned long& _mock_pin_mode_count() {
+    static unsigned long val = 0;
+    return val;
+}
+
 inline void _mock_reset_pins() {
+    _mock_digital_write_count() = 0;
+    _mock_pin_mode_count() = 0;
     for (uint8_t i = 0; i < MOCK_PIN_COUNT; ++i) {
         _mock_digital_pins()[i] = 0;
         _mock_analog_pins()[i] = 0;
@@ -86,12 +106,55 @@ inline void _mock_reset_pins() {
     }
 }
 
+// Lets simulated buses (e.g. the mock SPI) watch pins, like a chip select.
+using _MockDigitalWriteHook = void (*)(uint8_t pin, uint8_t val);
+
+inline _MockDigitalWriteHook& _mock_digital_write_hook() {
+    static _MockDigitalWriteHook hook = nullptr;
+    return hook;
+}
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+
+// Every mock pin has an interrupt, with the same number.
+inline int digitalPinToInterrupt(uint8_t pin) {
+    return pin < MOCK_PIN_COUNT ? pin : NOT_AN_INTERRUPT;
+}
+
+using _MockInterruptHandler = void (*)();
+
+inline _MockInterruptHandler* _mock_interrupt_handlers() {
+    static _MockInterruptHandler handlers[MOCK_PIN_COUNT] = {};
+    return handlers;
+}
+
+inline void attachInterrupt(uint8_t interrupt, void (*handler)(), int) {
+    if (interrupt < MOCK_PIN_COUNT) _mock_interrupt_handlers()[interrupt] = handler;
+}
+
+inline void detachInterrupt(uint8_t interrupt) {
+    if (interrupt < MOCK_PIN_COUNT) _mock_interrupt_handlers()[interrupt] = nullptr;
+}
+
+// Set a pin, and run its interrupt handler if the level changed.
+inline void _mock_pin_change(uint8_t pin, int val) {
+    if (pin >= MOCK_PIN_COUNT) return;
+    const bool changed = _mock_digital_pins()[pin] != val;
+    _mock_digital_pins()[pin] = val;
+    if (changed && _mock_interrupt_handlers()[pin] != nullptr) _mock_interrupt_handlers()[pin]();
+}
+
 inline void noInterrupts() {}
 inline void interrupts() {}
 
-inline void pinMode(uint8_t, uint8_t) {}
+inline void pinMode(uint8_t, uint8_t) { ++_mock_pin_mode_count(); }
 inline void digitalWrite(uint8_t pin, uint8_t val) {
+    ++_mock_digital_write_count();
     if (pin < MOCK_PIN_COUNT) _mock_digital_pins()[pin] = val;
+    if (_mock_digital_write_hook() != nullptr) _mock_digital_write_hook()(pin, val);
 }
 inline int digitalRead(uint8_t pin) {
     if (pin >= MOCK_PIN_COUNT) return 0;
@@ -0,0 +1,61 @@
+#ifndef CtrlDelayMock_h
+#define CtrlDelayMock_h
+
+#include <Arduino.h>
+
+inline uint32_t& _mock_nanos_ref() {
+    static uint32_t val = 0;
+    return val;
+}
+
+inline unsigned long& _mock_settle_wait_count() {
+    static unsigned long val = 0;
+    return val;
+}
+
+inline unsigned long& _mock_settle_waited_ns() {
+    static unsigned long val = 0;
+    return val;
+}
+
+inline void _mock_reset_delay() {
+    _mock_nanos_ref() = 0;
+    _mock_settle_wait_count() = 0;
+    _mock_settle_waited_ns() = 0;
+}
+
+// Advances the mock nanosecond clock, carrying whole microseconds into micros().
+inline void _mock_advance_nanos(const uint32_t ns) {
+    const uint32_t before = _mock_nanos_ref();
+    _mock_nanos_ref() += ns;
+    _mock_micros_ref() += _mock_nanos_ref() / 1000 - before / 1000;
+}
+
+// Settle delay backend for the native test environment. Waiting advances a
+// nanosecond mock clock, and records how long was waited.
+struct CtrlDelayMock
+{
+    static constexpr bool FINE_TIMESTAMPS = true;
+
+    static void begin() { }
+
+    static void wait(const uint32_t ns)
+    {
+        ++_mock_settle_wait_count();
+        _mock_settle_waited_ns() += ns;
+        _mock_advance_nanos(ns);
+    }
+
+    static uint32_t now() { return _mock_nanos_ref(); }
+
+    static void waitSince(const uint32_t start, const uint32_t ns)
+    {
+        ++_mock_settle_wait_count();
+        const uint32_t elapsed = _mock_nanos_ref() - start;
+        if (elapsed >= ns) return;
+        _mock_settle_waited_ns() += ns - elapsed;
+        _mock_advance_nanos(ns - elapsed);
+    }
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef CtrlPinIOMock_h
+#define CtrlPinIOMock_h
+
+#include <Arduino.h>
+
+inline unsigned long& _mock_select_write_count() {
+    static unsigned long val = 0;
+    return val;
+}
+
+inline unsigned long& _mock_pin_read_count() {
+    static unsigned long val = 0;
+    return val;
+}
+
+// A simulated chip wired to some of the mock pins (e.g. a shift register).
+struct MockPinDevice
+{
+    virtual ~MockPinDevice() = default;
+    virtual void onWrite(uint8_t pin, bool value) = 0;
+    // Returns true if the device drives the pin, setting value.
+    virtual bool onRead(uint8_t pin, bool& value) = 0;
+};
+
+inline MockPinDevice*& _mock_pin_device() {
+    static MockPinDevice* device = nullptr;
+    return device;
+}
+
+inline void _mock_reset_pin_io() {
+    _mock_select_write_count() = 0;
+    _mock_pin_read_count() = 0;
+    _mock_pin_device() = nullptr;
+}
+
+// Pin I/O backend for the native test environment. It drives the mock pins,
+// and counts transactions like a port register backend would perform them.
+struct CtrlPinIOMock
+{
+    struct Pin { uint8_t number; };
+    struct Select { };
+
+    static void attach(Pin& pin, const uint8_t number) { pin.number = number; }
+
+    static void setMode(const uint8_t number, const uint8_t mode) { pinMode(number, mode); }
+
+    static bool read(const Pin& pin)
+    {
+        ++_mock_pin_read_count();
+        bool value;
+        if (_mock_pin_device() != nullptr && _mock_pin_device()->onRead(pin.number, value)) return value;
+        return digitalRead(pin.number);
+    }
+
+    static uint16_t readAnalog(const Pin& pin)
+    {
+        ++_mock_pin_read_count();
+        return analogRead(pin.number);
+    }
+
+    static void write(const Pin& pin, const bool value)
+    {
+        digitalWrite(pin.number, value);
+        if (_mock_pin_device() != nullptr) _mock_pin_device()->onWrite(pin.number, value);
+    }
+
+    static void attach(Select&, const uint8_t*, uint8_t) { }
+
+    static void write(const Select&, const uint8_t* pins, const uint8_t count, const uint8_t channel, const uint8_t changed)
+    {
+        ++_mock_select_write_count();
+        for (uint8_t i = 0; i < count; ++i) {
+            if (bitRead(changed, i)) digitalWrite(pins[i], bitRead(channel, i));
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef Mock74HC165_h
+#define Mock74HC165_h
+
+#include <Arduino.h>
+#include <CtrlPinIOMock.h>
+
+// A chain of 74HC165 parallel-in/serial-out shift registers on the mock pins.
+// A low latch (PL) loads the inputs, every rising clock (CP) edge shifts one
+// bit towards the data (QH) pin: the H input of the first chip comes out first.
+struct Mock74HC165 : MockPinDevice
+{
+    uint8_t dataPin;
+    uint8_t clockPin;
+    uint8_t latchPin;
+    uint8_t chips;
+    uint8_t inputs[32] = {};
+    uint8_t shifted[32] = {};
+    uint16_t position = 0;
+    bool clockLevel = LOW;
+    bool latched = false;
+    unsigned long loadCount = 0;
+
+    Mock74HC165(uint8_t dataPin, uint8_t clockPin, uint8_t latchPin, uint8_t chips)
+        : dataPin(dataPin), clockPin(clockPin), latchPin(latchPin), chips(chips)
+    {
+        _mock_pin_device() = this;
+    }
+
+    ~Mock74HC165() override
+    {
+        if (_mock_pin_device() == this) _mock_pin_device() = nullptr;
+    }
+
+    void setInput(uint8_t input, bool level)
+    {
+        if (level) {
+            this->inputs[input / 8] |= 1 << (input % 8);
+        } else {
+            this->inputs[input / 8] &= ~(1 << (input % 8));
+        }
+    }
+
+    void setAll(bool level)
+    {
+        for (auto& chip : this->inputs) chip = level ? 0xff : 0x00;
+    }
+
+    void onWrite(uint8_t pin, bool value) override
+    {
+        if (pin == this->latchPin) {
+            if (!value) {
+                for (uint8_t i = 0; i < 32; ++i) this->shifted[i] = this->inputs[i];
+                this->position = 0;
+                ++this->loadCount;
+            }
+            this->latched = !value;
+        } else if (pin == this->clockPin) {
+            if (value && !this->clockLevel && !this->latched) ++this->position;
+            this->clockLevel = value;
+        }
+    }
+
+    bool onRead(uint8_t pin, bool& value) override
+    {
+        if (pin != this->dataPin) return false;
+        if (this->position >= this->chips * 8) {
+            value = LOW; // The serial input (DS) of the last chip.
+        } else {
+            value = (this->shifted[this->position / 8] >> (7 - this->position % 8)) & 1;
+        }
+        return true;
+    }
+};
+
+#endif
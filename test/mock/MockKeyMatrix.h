@@ -0,0 +1,77 @@
+#ifndef MockKeyMatrix_h
+#define MockKeyMatrix_h
+
+#include <Arduino.h>
+#include <CtrlPinIOMock.h>
+
+// A keypad matrix without diodes on the mock pins. Writing a row pin low
+// strobes that row: a column reads low when a chain of pressed keys connects
+// it to the strobed row, so 3 keys on the corners of a rectangle ghost the 4th.
+struct MockKeyMatrix : MockPinDevice
+{
+    static constexpr uint8_t MAX_LINES = 16;
+
+    const uint8_t* rowPins;
+    uint8_t rows;
+    const uint8_t* colPins;
+    uint8_t cols;
+    bool keys[MAX_LINES][MAX_LINES] = {};
+    int strobed = -1;
+    unsigned long strobeCount = 0;
+
+    MockKeyMatrix(const uint8_t* rowPins, uint8_t rows, const uint8_t* colPins, uint8_t cols)
+        : rowPins(rowPins), rows(rows), colPins(colPins), cols(cols)
+    {
+        _mock_pin_device() = this;
+    }
+
+    ~MockKeyMatrix() override
+    {
+        if (_mock_pin_device() == this) _mock_pin_device() = nullptr;
+    }
+
+    void setKey(uint8_t row, uint8_t col, bool pressed) { this->keys[row][col] = pressed; }
+
+    // The level of a column while the strobed row is driven low.
+    bool columnLevel(uint8_t col) const
+    {
+        if (this->strobed < 0) return HIGH;
+        bool rowReached[MAX_LINES] = {};
+        bool colReached[MAX_LINES] = {};
+        rowReached[this->strobed] = true;
+        for (bool grown = true; grown;) {
+            grown = false;
+            for (uint8_t r = 0; r < this->rows; ++r) {
+                for (uint8_t c = 0; c < this->cols; ++c) {
+                    if (!this->keys[r][c] || rowReached[r] == colReached[c]) continue;
+                    rowReached[r] = colReached[c] = true;
+                    grown = true;
+                }
+            }
+        }
+        return colReached[col] ? LOW : HIGH;
+    }
+
+    void onWrite(uint8_t pin, bool value) override
+    {
+        for (uint8_t r = 0; r < this->rows; ++r) {
+            if (pin == this->rowPins[r] && !value) {
+                this->strobed = r;
+                ++this->strobeCount;
+            }
+        }
+    }
+
+    bool onRead(uint8_t pin, bool& value) override
+    {
+        for (uint8_t c = 0; c < this->cols; ++c) {
+            if (pin == this->colPins[c]) {
+                value = this->columnLevel(c);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef MockMCP23x17_h
+#define MockMCP23x17_h
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+
+// A MCP23017 (I2C) / MCP23S17 (SPI) GPIO expander, in the default
+// IOCON.BANK = 0 register layout. Port A is bits 0 - 7 of the pins, port B
+// bits 8 - 15. The INT pin (mirrored) goes low on a change of an enabled pin,
+// reading GPIO clears it.
+struct MockMCP23x17 : MockI2CDevice, MockSPIDevice
+{
+    static constexpr uint8_t IODIRA = 0x00;
+    static constexpr uint8_t GPINTENA = 0x04;
+    static constexpr uint8_t IOCON = 0x0A;
+    static constexpr uint8_t GPPUA = 0x0C;
+    static constexpr uint8_t GPIOA = 0x12;
+    static constexpr uint8_t GPIOB = 0x13;
+    static constexpr uint8_t REGISTER_COUNT = 0x16;
+
+    uint8_t address; // The I2C address, or the hardware address (A2 - A0) on SPI.
+    uint8_t chipSelect;
+    uint8_t intPin;
+    uint8_t registers[REGISTER_COUNT] = {};
+    uint16_t pins = 0xffff;
+    uint8_t pointer = 0;
+    uint8_t frameIndex = 0;
+    bool frameRead = false;
+    bool frameSelected = false;
+    unsigned long gpioReadCount = 0;
+
+    MockMCP23x17(uint8_t address, uint8_t chipSelect = UINT8_MAX, uint8_t intPin = UINT8_MAX)
+        : address(address), chipSelect(chipSelect), intPin(intPin)
+    {
+        this->registers[IODIRA] = 0xff;
+        this->registers[IODIRA + 1] = 0xff;
+        this->setInterrupt(false);
+    }
+
+    uint16_t getPair(uint8_t reg) const
+    {
+        return static_cast<uint16_t>(this->registers[reg] | this->registers[reg + 1] << 8);
+    }
+
+    void setPins(uint16_t pins)
+    {
+        const uint16_t changed = this->pins ^ pins;
+        this->pins = pins;
+        if (changed & this->getPair(GPINTENA)) this->setInterrupt(true);
+    }
+
+    void setPin(uint8_t pin, bool level)
+    {
+        this->setPins(level ? this->pins | 1 << pin : this->pins & ~(1 << pin));
+    }
+
+    void setInterrupt(bool active)
+    {
+        if (this->intPin < MOCK_PIN_COUNT) _mock_digital_pins()[this->intPin] = active ? LOW : HIGH;
+    }
+
+    uint8_t readRegister(uint8_t reg)
+    {
+        if (reg == GPIOA || reg == GPIOB) {
+            ++this->gpioReadCount;
+            this->setInterrupt(false);
+            return reg == GPIOA ? this->pins & 0xff : this->pins >> 8;
+        }
+        return this->registers[reg];
+    }
+
+    void advance()
+    {
+        // Byte mode (SEQOP) toggles between the A/B register pairs.
+        if (this->registers[IOCON] & 0x20) {
+            this->pointer ^= 1;
+        } else {
+            this->pointer = (this->pointer + 1) % REGISTER_COUNT;
+        }
+    }
+
+    void write(uint8_t value)
+    {
+        if (this->pointer == IOCON || this->pointer == IOCON + 1) {
+            this->registers[IOCON] = value;
+            this->registers[IOCON + 1] = value;
+        } else {
+            this->registers[this->pointer] = value;
+        }
+        this->advance();
+    }
+
+    uint8_t read()
+    {
+        const uint8_t value = this->readRegister(this->pointer);
+        this->advance();
+        return value;
+    }
+
+    uint8_t getAddress() const override { return this->address; }
+
+    void receive(const uint8_t* data, size_t length) override
+    {
+        if (length == 0) return;
+        this->pointer = data[0] % REGISTER_COUNT;
+        for (size_t i = 1; i < length; ++i) this->write(data[i]);
+    }
+
+    size_t transmit(uint8_t* data, size_t length) override
+    {
+        for (size_t i = 0; i < length; ++i) data[i] = this->read();
+        return length;
+    }
+
+    uint8_t getChipSelect() const override { return this->chipSelect; }
+
+    void beginFrame() override
+    {
+        this->frameIndex = 0;
+    }
+
+    uint8_t transfer(uint8_t data) override
+    {
+        const uint8_t index = this->frameIndex++;
+        if (index == 0) {
+            // Without IOCON.HAEN the hardware address is ignored.
+            const bool addressed = !(this->registers[IOCON] & 0x08) || ((data >> 1) & 0x07) == this->address;
+            this->frameSelected = (data & 0xf0) == 0x40 && addressed;
+            this->frameRead = data & 0x01;
+            return 0;
+        }
+        if (!this->frameSelected) return 0;
+        if (index == 1) {
+            this->pointer = data % REGISTER_COUNT;
+            return 0;
+        }
+        if (this->frameRead) return this->read();
+        this->write(data);
+        return 0;
+    }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef MockSpiAdc_h
+#define MockSpiAdc_h
+
+#include <Arduino.h>
+#include <SPI.h>
+
+// A MCP3008 / MCP3208 (one conversion per frame) or ADS7953 (manual mode,
+// the channel programmed in a frame is output two frames later) SPI ADC.
+struct MockSpiAdc : MockSPIDevice
+{
+    enum Type : uint8_t { MCP3008, MCP3208, ADS7953 };
+
+    Type type;
+    uint8_t chipSelect;
+    uint16_t inputs[16] = {};
+    uint8_t frame[3] = {};
+    uint8_t frameIndex = 0;
+    uint8_t channel = 0; // MCP3x08: the channel of the current frame.
+    uint16_t output = 0; // ADS7953: the result output in the current frame.
+    uint8_t programmed[2] = {}; // ADS7953: the channels programmed 2 frames, and 1 frame ago.
+    uint8_t nextChannel = 0; // ADS7953: the channel of the current frame.
+    unsigned long conversionCount = 0;
+    unsigned long conversions[16] = {};
+
+    MockSpiAdc(Type type, uint8_t chipSelect) : type(type), chipSelect(chipSelect) { }
+
+    uint8_t getChipSelect() const override { return this->chipSelect; }
+
+    uint16_t convert(uint8_t channel)
+    {
+        ++this->conversionCount;
+        ++this->conversions[channel];
+        return this->inputs[channel];
+    }
+
+    void beginFrame() override
+    {
+        this->frameIndex = 0;
+        if (this->type == ADS7953) {
+            this->programmed[0] = this->programmed[1];
+            this->programmed[1] = this->nextChannel;
+            const uint8_t converted = this->programmed[0];
+            this->output = static_cast<uint16_t>(converted << 12 | (this->convert(converted) & 0x0fff));
+        }
+    }
+
+    uint8_t transfer(uint8_t data) override
+    {
+        const uint8_t index = this->frameIndex++;
+        if (index < 3) this->frame[index] = data;
+        if (this->type == ADS7953) {
+            if (index == 1) {
+                const uint16_t command = static_cast<uint16_t>(this->frame[0] << 8 | data);
+                if ((command >> 12) == 0x1 && (command & 0x0800)) this->nextChannel = (command >> 7) & 0x0f;
+                return this->output & 0xff;
+            }
+            return index == 0 ? this->output >> 8 : 0;
+        }
+        if (index == 1) {
+            if (this->type == MCP3008) {
+                if (!(this->frame[0] & 0x01) || !(data & 0x80)) return 0;
+                this->channel = (data >> 4) & 0x07;
+            } else {
+                if ((this->frame[0] & 0x06) != 0x06) return 0;
+                this->channel = static_cast<uint8_t>((this->frame[0] & 0x01) << 2 | data >> 6);
+            }
+            this->output = this->convert(this->channel);
+            return this->type == MCP3008 ? (this->output >> 8) & 0x03 : (this->output >> 8) & 0x0f;
+        }
+        if (index == 2) return this->output & 0xff;
+        return 0;
+    }
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef SPI_h
+#define SPI_h
+
+#include <Arduino.h>
+
+#ifndef MSBFIRST
+#define MSBFIRST 1
+#endif
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+#define SPI_HAS_NOTUSINGINTERRUPT 1
+
+// A simulated chip on the mock SPI bus. It only sees the bytes transferred
+// while its chip select pin is low, a frame starts when it goes low.
+struct MockSPIDevice
+{
+    virtual ~MockSPIDevice() = default;
+    virtual uint8_t getChipSelect() const = 0;
+    virtual void beginFrame() = 0;
+    virtual uint8_t transfer(uint8_t data) = 0;
+};
+
+class SPISettings
+{
+    public:
+        uint32_t clock;
+        uint8_t bitOrder;
+        uint8_t dataMode;
+
+        SPISettings() : clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) { }
+        SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+            : clock(clock), bitOrder(bitOrder), dataMode(dataMode) { }
+};
+
+class SPIClass
+{
+    public:
+        static constexpr uint8_t MAX_DEVICES = 8;
+
+        MockSPIDevice* devices[MAX_DEVICES] = {};
+        SPISettings settings;
+        bool inTransaction = false;
+        unsigned long transactionCount = 0;
+        unsigned long transferCount = 0;
+        uint8_t usedInterrupt = 0; // The last usingInterrupt() argument, 0 for none.
+
+        SPIClass()
+        {
+            _mock_digital_write_hook() = &SPIClass::pinWritten;
+        }
+
+        static void pinWritten(uint8_t pin, uint8_t val);
+
+        void begin() { }
+        void end() { }
+
+        void attach(MockSPIDevice* device)
+        {
+            for (auto& slot : this->devices) {
+                if (slot == nullptr) {
+                    slot = device;
+                    return;
+                }
+            }
+        }
+
+        void detach(MockSPIDevice* device)
+        {
+            for (auto& slot : this->devices) {
+                if (slot == device) slot = nullptr;
+            }
+        }
+
+        void reset()
+        {
+            for (auto& slot : this->devices) slot = nullptr;
+            this->inTransaction = false;
+            this->transactionCount = 0;
+            this->transferCount = 0;
+            this->usedInterrupt = 0;
+        }
+
+        void beginTransaction(SPISettings settings)
+        {
+            this->settings = settings;
+            this->inTransaction = true;
+            ++this->transactionCount;
+        }
+
+        void endTransaction() { this->inTransaction = false; }
+
+        void usingInterrupt(uint8_t interruptNumber) { this->usedInterrupt = interruptNumber; }
+        void notUsingInterrupt(uint8_t) { this->usedInterrupt = 0; }
+
+        uint8_t transfer(uint8_t data)
+        {
+            ++this->transferCount;
+            uint8_t received = 0;
+            for (auto* device : this->devices) {
+                if (device != nullptr && digitalRead(device->getChipSelect()) == LOW) {
+                    received |= device->transfer(data);
+                }
+            }
+            return received;
+        }
+
+        void transfer(void* buffer, size_t count)
+        {
+            auto* bytes = static_cast<uint8_t*>(buffer);
+            for (size_t i = 0; i < count; ++i) bytes[i] = this->transfer(bytes[i]);
+        }
+};
+
+inline SPIClass SPI;
+
+inline void SPIClass::pinWritten(uint8_t pin, uint8_t val)
+{
+    if (val != LOW) return;
+    for (auto* device : SPI.devices) {
+        if (device != nullptr && device->getChipSelect() == pin) device->beginFrame();
+    }
+}
+
+#endif
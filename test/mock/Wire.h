@@ -0,0 +1,118 @@
+#ifndef Wire_h
+#define Wire_h
+
+#include <Arduino.h>
+
+// A simulated chip on the mock I2C bus.
+struct MockI2CDevice
+{
+    virtual ~MockI2CDevice() = default;
+    virtual uint8_t getAddress() const = 0;
+    // Bytes written in one transmission.
+    virtual void receive(const uint8_t* data, size_t length) = 0;
+    // Bytes requested by the master, returns the number of bytes sent.
+    virtual size_t transmit(uint8_t* data, size_t length) = 0;
+};
+
+class TwoWire
+{
+    public:
+        static constexpr uint8_t BUFFER_LENGTH = 32;
+        static constexpr uint8_t MAX_DEVICES = 8;
+
+        MockI2CDevice* devices[MAX_DEVICES] = {};
+        uint8_t txAddress = 0;
+        uint8_t txBuffer[BUFFER_LENGTH] = {};
+        size_t txLength = 0;
+        uint8_t rxBuffer[BUFFER_LENGTH] = {};
+        size_t rxLength = 0;
+        size_t rxIndex = 0;
+        unsigned long transmissionCount = 0;
+        unsigned long requestCount = 0;
+
+        void begin() { }
+        void setClock(uint32_t) { }
+
+        void attach(MockI2CDevice* device)
+        {
+            for (auto& slot : this->devices) {
+                if (slot == nullptr) {
+                    slot = device;
+                    return;
+                }
+            }
+        }
+
+        void detach(MockI2CDevice* device)
+        {
+            for (auto& slot : this->devices) {
+                if (slot == device) slot = nullptr;
+            }
+        }
+
+        void reset()
+        {
+            for (auto& slot : this->devices) slot = nullptr;
+            this->txLength = 0;
+            this->rxLength = 0;
+            this->rxIndex = 0;
+            this->transmissionCount = 0;
+            this->requestCount = 0;
+        }
+
+        void beginTransmission(uint8_t address)
+        {
+            this->txAddress = address;
+            this->txLength = 0;
+        }
+
+        size_t write(uint8_t data)
+        {
+            if (this->txLength >= BUFFER_LENGTH) return 0;
+            this->txBuffer[this->txLength++] = data;
+            return 1;
+        }
+
+        // 0: success, 2: address not acknowledged.
+        uint8_t endTransmission(bool = true)
+        {
+            ++this->transmissionCount;
+            MockI2CDevice* device = this->find(this->txAddress);
+            if (device == nullptr) return 2;
+            device->receive(this->txBuffer, this->txLength);
+            return 0;
+        }
+
+        uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t = 1)
+        {
+            ++this->requestCount;
+            this->rxIndex = 0;
+            this->rxLength = 0;
+            MockI2CDevice* device = this->find(address);
+            if (device == nullptr) return 0;
+            if (quantity > BUFFER_LENGTH) quantity = BUFFER_LENGTH;
+            this->rxLength = device->transmit(this->rxBuffer, quantity);
+            return static_cast<uint8_t>(this->rxLength);
+        }
+
+        int available() const { return static_cast<int>(this->rxLength - this->rxIndex); }
+
+        int read()
+        {
+            if (this->rxIndex >= this->rxLength) return -1;
+            return this->rxBuffer[this->rxIndex++];
+        }
+
+    private:
+        MockI2CDevice* find(uint8_t address) const
+        {
+            for (auto* device : this->devices) {
+                if (device != nullptr && device->getAddress() == address) return device;
+            }
+            return nullptr;
+        }
+};
+
+inline TwoWire Wire;
+
+#endif
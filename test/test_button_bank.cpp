@@ -0,0 +1,214 @@
+#include <Arduino.h>
+#include <CtrlBtnBank.h>
+#include <CtrlMux.h>
+#include <CtrlPinIOMock.h>
+#include <CtrlShiftIn.h>
+#include <Mock74HC165.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static uint8_t lastIndex = UINT8_MAX;
+
+static void recordPress(const uint8_t index)
+{
+    lastIndex = index;
+    tracker.recordPress();
+}
+
+static void recordRelease(const uint8_t index)
+{
+    lastIndex = index;
+    tracker.recordRelease();
+}
+
+static void recordDelayedRelease(const uint8_t index)
+{
+    lastIndex = index;
+    tracker.recordDelayedRelease();
+}
+
+// Pull-up levels: every button released, except the given ones.
+static uint32_t levelsWith(const uint32_t pressedMask)
+{
+    return ~pressedMask;
+}
+
+static void test_button_bank_presses_after_four_equal_samples()
+{
+    CtrlBtnBank<uint8_t> bank(0, 8, TEST_DEBOUNCE, recordPress, recordRelease);
+
+    bank.update(levelsWith(0));
+
+    for (int i = 0; i < 3; ++i) TEST_ASSERT_EQUAL_UINT8(0, bank.update(levelsWith(0x04)));
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    TEST_ASSERT_EQUAL_UINT8(0x04, bank.update(levelsWith(0x04)));
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(2, lastIndex);
+    TEST_ASSERT_TRUE(bank.isPressed(2));
+    TEST_ASSERT_TRUE(bank.isReleased(3));
+
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0));
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_EQUAL_UINT8(0, bank.getPressed());
+}
+
+static void test_button_bank_ignores_bounces()
+{
+    CtrlBtnBank<uint16_t> bank(0, 16, TEST_DEBOUNCE, recordPress, recordRelease);
+
+    bank.update(levelsWith(0));
+
+    // A bouncing contact never stays down for 4 samples in a row.
+    for (int i = 0; i < 20; ++i) bank.update(levelsWith(i % 3 == 2 ? 0 : 0x8001));
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    // Buttons are debounced independently: one settles while the other bounces.
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(i % 2 == 0 ? 0x8001 : 0x0001));
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(0, lastIndex);
+    TEST_ASSERT_EQUAL_UINT16(0x0001, bank.getPressed());
+}
+
+static void test_button_bank_delayed_release()
+{
+    CtrlBtnBank<uint32_t> bank(0, 32, TEST_DEBOUNCE, recordPress, recordRelease, recordDelayedRelease);
+    bank.setDelayedReleaseDuration(100);
+
+    bank.update(levelsWith(0));
+
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0x80000000ul));
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(31, lastIndex);
+
+    delay(101);
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0));
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0x80000000ul));
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0));
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_button_bank_reads_shift_in_run()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 3);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 3);
+
+    chain.inputs[0] = 0xf0;
+    chain.inputs[1] = 0x5a;
+    chain.inputs[2] = 0x0f;
+    shiftIn.capture();
+
+    // Inputs 4 - 19 across 3 chips.
+    TEST_ASSERT_EQUAL_UINT32(0xf5afu, shiftIn.readBtnBits(4, 16, INPUT_PULLUP));
+    TEST_ASSERT_EQUAL_UINT32(0x0f5af0u, shiftIn.readBtnBits(0, 32, INPUT_PULLUP));
+    TEST_ASSERT_EQUAL_UINT32(0, shiftIn.readBtnBits(24, 8, INPUT_PULLUP));
+}
+
+static void test_button_bank_on_shift_in()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 3);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 3);
+
+    CtrlBtnBank<uint16_t> bank(4, 16, TEST_DEBOUNCE, recordPress, recordRelease, nullptr, &shiftIn);
+
+    chain.setAll(HIGH);
+    shiftIn.process();
+
+    chain.setInput(12, LOW);
+    for (int i = 0; i < 4; ++i) {
+        delay(TEST_DEBOUNCE / 3);
+        shiftIn.process();
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(8, lastIndex);
+
+    chain.setInput(12, HIGH);
+    for (int i = 0; i < 4; ++i) {
+        delay(TEST_DEBOUNCE / 3);
+        shiftIn.process();
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_button_bank_samples_once_per_interval()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 1);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN);
+
+    CtrlBtnBank<uint8_t> bank(0, 8, TEST_DEBOUNCE, recordPress, nullptr, nullptr, &shiftIn);
+
+    chain.setAll(HIGH);
+    shiftIn.process();
+
+    // Passes within the sample interval don't count as samples.
+    chain.setInput(0, LOW);
+    for (int i = 0; i < 20; ++i) shiftIn.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    for (int sample = 0; sample < 3; ++sample) {
+        delay(TEST_DEBOUNCE / 3);
+        for (int i = 0; i < 20; ++i) shiftIn.process();
+    }
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    delay(TEST_DEBOUNCE / 3);
+    shiftIn.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_button_bank_reads_mux_snapshot_frame()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlBtnBank<uint8_t> bank(8, 8, TEST_DEBOUNCE, recordPress, recordRelease, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_reset_pin_io();
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    for (int i = 0; i < 4; ++i) {
+        delay(TEST_DEBOUNCE / 3);
+        mux.process();
+    }
+
+    // Every channel of the bank is sampled once per pass, the bank reads the frame.
+    TEST_ASSERT_EQUAL_INT(32, _mock_pin_read_count());
+    TEST_ASSERT_EQUAL_INT(8, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(0xff, bank.getPressed());
+}
+
+static void test_button_bank_disabled_ignores_changes()
+{
+    CtrlBtnBank<uint8_t> bank(0, 4, TEST_DEBOUNCE, recordPress, recordRelease);
+
+    bank.update(levelsWith(0));
+    bank.disable();
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0x01));
+    bank.enable();
+    for (int i = 0; i < 4; ++i) bank.update(levelsWith(0x01));
+
+    // Re-enabling takes the current levels without events.
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    TEST_ASSERT_TRUE(bank.isPressed(0));
+    TEST_ASSERT_EQUAL_UINT8(4, bank.getCount());
+}
+
+void run_button_bank_tests()
+{
+    RUN_TEST(test_button_bank_presses_after_four_equal_samples);
+    RUN_TEST(test_button_bank_ignores_bounces);
+    RUN_TEST(test_button_bank_delayed_release);
+    RUN_TEST(test_button_bank_reads_shift_in_run);
+    RUN_TEST(test_button_bank_on_shift_in);
+    RUN_TEST(test_button_bank_samples_once_per_interval);
+    RUN_TEST(test_button_bank_reads_mux_snapshot_frame);
+    RUN_TEST(test_button_bank_disabled_ignores_changes);
+}
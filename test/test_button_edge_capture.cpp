@@ -0,0 +1,224 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlClock.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static unsigned long edgeClockMicros = 0;
+
+static unsigned long edgeClockMillisSource()
+{
+    return edgeClockMicros / 1000;
+}
+
+static unsigned long edgeClockMicrosSource()
+{
+    return edgeClockMicros;
+}
+
+static void useEdgeClock()
+{
+    edgeClockMicros = 1000000;
+    CtrlClock::setSource(edgeClockMillisSource, edgeClockMicrosSource);
+}
+
+static void advanceMillis(const unsigned long ms)
+{
+    edgeClockMicros += ms * 1000;
+}
+
+static void test_edge_capture_keeps_edges_between_calls()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    // A 30 ms tap, entirely between two process() calls.
+    _mock_pin_change(BTN_PIN, LOW);
+    advanceMillis(30);
+    _mock_pin_change(BTN_PIN, HIGH);
+    advanceMillis(50);
+    button.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_TRUE(button.isReleased());
+}
+
+static void test_edge_capture_debounces_from_edge_time()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    // The loop was busy: the first call after the edge is already past the debounce.
+    _mock_pin_change(BTN_PIN, LOW);
+    advanceMillis(TEST_DEBOUNCE + 5);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_edge_capture_bounce_within_debounce_is_ignored()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    _mock_pin_change(BTN_PIN, LOW);
+    advanceMillis(2);
+    _mock_pin_change(BTN_PIN, HIGH);
+    advanceMillis(2);
+    _mock_pin_change(BTN_PIN, LOW);
+    advanceMillis(TEST_DEBOUNCE - 1);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    advanceMillis(1);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+}
+
+static void test_edge_capture_delayed_release_uses_edge_times()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE,
+        []{ tracker.recordPress(); },
+        []{ tracker.recordRelease(); },
+        []{ tracker.recordDelayedRelease(); }
+    );
+    button.setDelayedReleaseDuration(100);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    // Held for 60 ms, but only seen 400 ms later: a normal release.
+    _mock_pin_change(BTN_PIN, LOW);
+    advanceMillis(60);
+    _mock_pin_change(BTN_PIN, HIGH);
+    advanceMillis(400);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.delayedReleaseCount);
+
+    // Held for 120 ms.
+    _mock_pin_change(BTN_PIN, LOW);
+    advanceMillis(120);
+    _mock_pin_change(BTN_PIN, HIGH);
+    advanceMillis(20);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(2, tracker.pressCount);
+}
+
+static void test_edge_capture_store_pin_state_with_time()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+
+    const unsigned long pressed = edgeClockMicros;
+    button.storePinState(LOW, pressed);
+    button.storePinState(HIGH, pressed + 25000);
+    advanceMillis(40);
+    button.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_edge_capture_settles_on_poll_at_edge_time()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE,
+        []{ tracker.recordPress(); },
+        []{ tracker.recordRelease(); },
+        []{ tracker.recordDelayedRelease(); }
+    );
+    button.setDelayedReleaseDuration(100);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+
+    // Without pin interrupts: the debounces complete on polls without a new edge.
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.storePinState(LOW, edgeClockMicros);
+    advanceMillis(1);
+    button.process();
+    advanceMillis(39);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+
+    // Held for 105 ms from edge to edge.
+    advanceMillis(65);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.storePinState(HIGH, edgeClockMicros);
+    advanceMillis(1);
+    button.process();
+    advanceMillis(19);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+}
+
+static void test_edge_capture_overflow_keeps_latest_state()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    // Far more bounces than slots, ending low.
+    for (int i = 0; i < 21; ++i) {
+        _mock_pin_change(BTN_PIN, i % 2 == 0 ? LOW : HIGH);
+        advanceMillis(1);
+    }
+    advanceMillis(TEST_DEBOUNCE);
+    button.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+    TEST_ASSERT_TRUE(button.isPressed());
+}
+
+static void test_edge_capture_late_in_pass_keeps_debounce()
+{
+    useEdgeClock();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    int pressesInPass = 0;
+    {
+        // The objects before the button took longer than the debounce.
+        const CtrlClock::Pass pass;
+        _mock_pin_change(BTN_PIN, LOW);
+        advanceMillis(TEST_DEBOUNCE + 50);
+        button.process();
+        pressesInPass = tracker.pressCount;
+    }
+    TEST_ASSERT_EQUAL_INT(0, pressesInPass);
+
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+void run_button_edge_capture_tests()
+{
+    RUN_TEST(test_edge_capture_keeps_edges_between_calls);
+    RUN_TEST(test_edge_capture_debounces_from_edge_time);
+    RUN_TEST(test_edge_capture_bounce_within_debounce_is_ignored);
+    RUN_TEST(test_edge_capture_delayed_release_uses_edge_times);
+    RUN_TEST(test_edge_capture_store_pin_state_with_time);
+    RUN_TEST(test_edge_capture_settles_on_poll_at_edge_time);
+    RUN_TEST(test_edge_capture_overflow_keeps_latest_state);
+    RUN_TEST(test_edge_capture_late_in_pass_keeps_debounce);
+}
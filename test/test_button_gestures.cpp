@@ -0,0 +1,240 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "CtrlBtn.h"
+#include "CtrlGroup.h"
+#include "test_globals.h"
+
+static int gestureClicks[4];
+static int gestureLongPresses;
+static int gestureRepeats;
+static unsigned long gestureRepeatTimes[8];
+
+static void resetGestureCounts()
+{
+    for (int& clicks : gestureClicks) clicks = 0;
+    gestureLongPresses = 0;
+    gestureRepeats = 0;
+}
+
+static void gesturePress(CtrlBtn& button)
+{
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+}
+
+static void gestureRelease(CtrlBtn& button)
+{
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+}
+
+static void test_gesture_single_double_triple_click()
+{
+    resetGestureCounts();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    button.setOnClick([](const uint8_t clicks) { ++gestureClicks[clicks]; });
+    button.setClickWindow(100);
+    button.process();
+
+    gesturePress(button);
+    gestureRelease(button);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, gestureClicks[1]); // Waits for a second click.
+    delay(100);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[1]);
+
+    gesturePress(button);
+    gestureRelease(button);
+    gesturePress(button);
+    gestureRelease(button);
+    delay(100);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[2]);
+
+    // The 3rd click fires right away.
+    gesturePress(button);
+    gestureRelease(button);
+    gesturePress(button);
+    gestureRelease(button);
+    gesturePress(button);
+    gestureRelease(button);
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[3]);
+    delay(100);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[1]);
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[2]);
+}
+
+static void test_gesture_press_after_window_starts_new_click()
+{
+    resetGestureCounts();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    button.setOnClick([](const uint8_t clicks) { ++gestureClicks[clicks]; });
+    button.setClickWindow(50);
+    button.process();
+
+    gesturePress(button);
+    gestureRelease(button);
+    delay(60);
+    gesturePress(button);
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[1]);
+    gestureRelease(button);
+    delay(50);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(2, gestureClicks[1]);
+    TEST_ASSERT_EQUAL_INT(0, gestureClicks[2]);
+}
+
+static void test_gesture_long_press_fires_while_held()
+{
+    resetGestureCounts();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.setOnClick([](const uint8_t clicks) { ++gestureClicks[clicks]; });
+    button.setOnLongPress([]{ ++gestureLongPresses; });
+    button.setLongPressDuration(200);
+    button.process();
+
+    gesturePress(button);
+    delay(150);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, gestureLongPresses);
+    delay(50);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureLongPresses);
+    delay(500);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureLongPresses);
+
+    // A long press is not a click.
+    gestureRelease(button);
+    delay(500);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, gestureClicks[1]);
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_gesture_repeat_accelerates()
+{
+    resetGestureCounts();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    button.setOnRepeat([]{
+        if (gestureRepeats < 8) gestureRepeatTimes[gestureRepeats] = millis();
+        ++gestureRepeats;
+    });
+    button.setRepeat(300, 80, 40);
+    button.process();
+
+    gesturePress(button);
+    const unsigned long pressed = millis();
+    for (int i = 0; i < 1000 && gestureRepeats < 8; ++i) {
+        delay(1);
+        button.process();
+    }
+    TEST_ASSERT_EQUAL_INT(8, gestureRepeats);
+    TEST_ASSERT_EQUAL_UINT32(300, gestureRepeatTimes[0] - pressed);
+    TEST_ASSERT_EQUAL_UINT32(80, gestureRepeatTimes[1] - gestureRepeatTimes[0]);
+    TEST_ASSERT_EQUAL_UINT32(70, gestureRepeatTimes[2] - gestureRepeatTimes[1]);
+    TEST_ASSERT_TRUE(gestureRepeatTimes[7] - gestureRepeatTimes[6] >= 40);
+    TEST_ASSERT_TRUE(gestureRepeatTimes[7] - gestureRepeatTimes[6] < 50);
+
+    gestureRelease(button);
+    const int repeats = gestureRepeats;
+    delay(1000);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(repeats, gestureRepeats);
+}
+
+static void test_gesture_group_callbacks()
+{
+    resetGestureCounts();
+    CtrlGroup group;
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    group.addObject(&button);
+    group.setOnClick([](Groupable&, const uint8_t clicks) { ++gestureClicks[clicks]; });
+    group.setOnLongPress([](Groupable&) { ++gestureLongPresses; });
+    button.setLongPressDuration(100);
+    group.process();
+
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    group.process();
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    group.process();
+    delay(300);
+    group.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureClicks[1]);
+
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    group.process();
+    delay(100);
+    group.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureLongPresses);
+}
+
+static void test_gesture_without_handlers_is_idle()
+{
+    resetGestureCounts();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.attachPinInterrupts();
+    button.process();
+
+    _mock_pin_change(BTN_PIN, LOW);
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    // Held, without gesture handlers: nothing to do.
+    TEST_ASSERT_FALSE(button.needsProcessing());
+
+    button.setOnLongPress([]{ ++gestureLongPresses; });
+    TEST_ASSERT_TRUE(button.needsProcessing());
+    delay(500);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, gestureLongPresses);
+    TEST_ASSERT_FALSE(button.needsProcessing());
+    button.detachPinInterrupts();
+}
+
+static void test_gesture_shares_the_clock_read()
+{
+    resetGestureCounts();
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    button.setOnRepeat([]{ ++gestureRepeats; });
+    button.setOnLongPress([]{ ++gestureLongPresses; });
+    button.process();
+    gesturePress(button);
+
+    // Held, outside of a pass: the state & the gestures share one clock read.
+    _mock_millis_call_count() = 0;
+    button.process();
+    TEST_ASSERT_EQUAL_UINT32(1, _mock_millis_call_count());
+    delay(600);
+    _mock_millis_call_count() = 0;
+    button.process();
+    TEST_ASSERT_EQUAL_UINT32(1, _mock_millis_call_count());
+    TEST_ASSERT_EQUAL_INT(1, gestureLongPresses);
+    TEST_ASSERT_EQUAL_INT(1, gestureRepeats);
+}
+
+void run_button_gesture_tests()
+{
+    RUN_TEST(test_gesture_single_double_triple_click);
+    RUN_TEST(test_gesture_press_after_window_starts_new_click);
+    RUN_TEST(test_gesture_long_press_fires_while_held);
+    RUN_TEST(test_gesture_repeat_accelerates);
+    RUN_TEST(test_gesture_group_callbacks);
+    RUN_TEST(test_gesture_without_handlers_is_idle);
+    RUN_TEST(test_gesture_shares_the_clock_read);
+}
@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "CtrlBtn.h"
+#include "test_globals.h"
+
+static void stopSequence(const uint8_t pin, const int level)
+{
+    _mock_digital_sequences()[pin].length = 0;
+    _mock_digital_pins()[pin] = level;
+}
+
+static void test_button_leading_edge_fires_on_first_edge()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.setLeadingEdge(true);
+
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+
+    // The contact bounces: the first low reading is the press, no time has to pass.
+    const int bounces[] = {LOW, HIGH, LOW, HIGH, HIGH, LOW, LOW, LOW};
+    _mock_set_digital_sequence(BTN_PIN, bounces, 8);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_TRUE(button.isPressed());
+
+    for (int i = 0; i < 7; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+
+    // Held down past the lockout: nothing more to report.
+    stopSequence(BTN_PIN, LOW);
+    delay(TEST_DEBOUNCE);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.eventCount);
+}
+
+static void test_button_leading_edge_release_ignores_bounces()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.setLeadingEdge(true);
+
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    delay(TEST_DEBOUNCE);
+
+    const int bounces[] = {HIGH, LOW, HIGH, LOW, HIGH, HIGH};
+    _mock_set_digital_sequence(BTN_PIN, bounces, 6);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+
+    for (int i = 0; i < 5; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_TRUE(button.isReleased());
+}
+
+static void test_button_leading_edge_reports_short_tap_after_lockout()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.setLeadingEdge(true, 20);
+
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+
+    // Released within the lockout: reported once the lockout is over.
+    delay(5);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+
+    delay(10);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+
+    delay(5);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_TRUE(button.isReleased());
+}
+
+static void test_button_leading_edge_delayed_release()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE,
+        []{ tracker.recordPress(); },
+        []{ tracker.recordRelease(); },
+        []{ tracker.recordDelayedRelease(); }
+    );
+    button.setLeadingEdge(true);
+    button.setDelayedReleaseDuration(100);
+
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+
+    delay(100);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+
+    delay(TEST_DEBOUNCE);
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    delay(TEST_DEBOUNCE);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_button_leading_edge_can_be_turned_off()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    button.setLeadingEdge(true);
+    button.setLeadingEdge(false);
+
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+void run_button_leading_edge_tests()
+{
+    RUN_TEST(test_button_leading_edge_fires_on_first_edge);
+    RUN_TEST(test_button_leading_edge_release_ignores_bounces);
+    RUN_TEST(test_button_leading_edge_reports_short_tap_after_lockout);
+    RUN_TEST(test_button_leading_edge_delayed_release);
+    RUN_TEST(test_button_leading_edge_can_be_turned_off);
+}
@@ -0,0 +1,211 @@
+#include <Arduino.h>
+#include <CtrlBtnMatrix.h>
+#include <CtrlEventQueue.h>
+#include <CtrlPinIOMock.h>
+#include <MockKeyMatrix.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static constexpr uint8_t MATRIX_ROWS[4] = {30, 31, 32, 33};
+static constexpr uint8_t MATRIX_COLS[4] = {34, 35, 36, 37};
+static constexpr uint8_t MATRIX_INTERVAL = (TEST_DEBOUNCE + 2) / 3;
+
+static uint8_t lastMatrixIndex = UINT8_MAX;
+
+static void recordMatrixPress(const uint8_t index)
+{
+    lastMatrixIndex = index;
+    tracker.recordPress();
+}
+
+static void recordMatrixRelease(const uint8_t index)
+{
+    lastMatrixIndex = index;
+    tracker.recordRelease();
+}
+
+static void recordMatrixDelayedRelease(const uint8_t index)
+{
+    lastMatrixIndex = index;
+    tracker.recordDelayedRelease();
+}
+
+template <typename Matrix>
+static void scanMatrix(Matrix& matrix, const uint8_t samples)
+{
+    for (uint8_t i = 0; i < samples; ++i) {
+        delay(MATRIX_INTERVAL);
+        matrix.process();
+    }
+}
+
+// Columns on a source, read from the simulated matrix.
+struct MatrixColumnSource : CtrlSource
+{
+    MockKeyMatrix& keys;
+    unsigned long readCount = 0;
+
+    explicit MatrixColumnSource(MockKeyMatrix& keys) : keys(keys) { }
+
+    bool readBtnSig(const uint8_t channel, uint8_t) override
+    {
+        ++this->readCount;
+        return this->keys.columnLevel(channel);
+    }
+
+    bool readEncClk(uint8_t, uint8_t) override { return HIGH; }
+    bool readEncDt(uint8_t, uint8_t) override { return HIGH; }
+    uint16_t readPotSig(uint8_t, uint8_t) override { return 0; }
+};
+
+static void test_button_matrix_press_and_release()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, MATRIX_COLS, TEST_DEBOUNCE, recordMatrixPress, recordMatrixRelease);
+    matrix.process();
+    // One strobe per row, per scan.
+    TEST_ASSERT_EQUAL_UINT32(4, keys.strobeCount);
+
+    keys.setKey(2, 1, true);
+    scanMatrix(matrix, 3);
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    scanMatrix(matrix, 1);
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(2 * 4 + 1, lastMatrixIndex);
+    TEST_ASSERT_TRUE(matrix.isPressed(9));
+    TEST_ASSERT_EQUAL_UINT8(0x02, matrix.getPressed(2));
+    TEST_ASSERT_EQUAL_UINT32(20, keys.strobeCount);
+
+    keys.setKey(2, 1, false);
+    scanMatrix(matrix, 4);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_TRUE(matrix.isReleased(9));
+}
+
+static void test_button_matrix_scans_once_per_interval()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, MATRIX_COLS, TEST_DEBOUNCE);
+    matrix.process();
+    matrix.process();
+    matrix.process();
+    TEST_ASSERT_EQUAL_UINT32(4, keys.strobeCount);
+    delay(MATRIX_INTERVAL);
+    matrix.process();
+    TEST_ASSERT_EQUAL_UINT32(8, keys.strobeCount);
+}
+
+static void test_button_matrix_bounce_restarts_count()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, MATRIX_COLS, TEST_DEBOUNCE, recordMatrixPress);
+    matrix.process();
+
+    keys.setKey(0, 3, true);
+    scanMatrix(matrix, 3);
+    keys.setKey(0, 3, false);
+    scanMatrix(matrix, 1);
+    keys.setKey(0, 3, true);
+    scanMatrix(matrix, 3);
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    scanMatrix(matrix, 1);
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(3, lastMatrixIndex);
+}
+
+static void test_button_matrix_suppresses_ghosts()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, MATRIX_COLS, TEST_DEBOUNCE, recordMatrixPress, recordMatrixRelease);
+    matrix.process();
+
+    keys.setKey(0, 0, true);
+    keys.setKey(0, 1, true);
+    scanMatrix(matrix, 4);
+    TEST_ASSERT_EQUAL_INT(2, tracker.pressCount);
+
+    // A 3rd corner of the rectangle: row 1 reads columns 0 & 1.
+    keys.setKey(1, 0, true);
+    scanMatrix(matrix, 8);
+    TEST_ASSERT_TRUE(matrix.hasGhosts());
+    TEST_ASSERT_EQUAL_INT(2, tracker.pressCount);
+    TEST_ASSERT_TRUE(matrix.isReleased(4));
+    TEST_ASSERT_TRUE(matrix.isReleased(5));
+
+    // Without the ambiguity, the real key comes through.
+    keys.setKey(0, 1, false);
+    scanMatrix(matrix, 4);
+    TEST_ASSERT_FALSE(matrix.hasGhosts());
+    TEST_ASSERT_TRUE(matrix.isPressed(4));
+    TEST_ASSERT_TRUE(matrix.isReleased(5));
+    TEST_ASSERT_TRUE(matrix.isReleased(1));
+    TEST_ASSERT_EQUAL_INT(3, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_button_matrix_without_ghost_detection()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, MATRIX_COLS, TEST_DEBOUNCE, recordMatrixPress);
+    matrix.setGhostDetection(false);
+    matrix.process();
+
+    keys.setKey(0, 0, true);
+    keys.setKey(0, 1, true);
+    keys.setKey(1, 0, true);
+    scanMatrix(matrix, 4);
+    // The ghost reads as a 4th press.
+    TEST_ASSERT_EQUAL_INT(4, tracker.pressCount);
+    TEST_ASSERT_TRUE(matrix.isPressed(5));
+}
+
+static void test_button_matrix_columns_on_source()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    MatrixColumnSource source(keys);
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, &source, 0, TEST_DEBOUNCE,
+        recordMatrixPress, recordMatrixRelease, recordMatrixDelayedRelease);
+    matrix.setDelayedReleaseDuration(100);
+    matrix.process();
+    TEST_ASSERT_EQUAL_UINT32(16, source.readCount);
+
+    keys.setKey(3, 2, true);
+    scanMatrix(matrix, 4);
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_UINT8(3 * 4 + 2, lastMatrixIndex);
+
+    delay(100);
+    keys.setKey(3, 2, false);
+    scanMatrix(matrix, 4);
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+}
+
+static void test_button_matrix_events_to_queue()
+{
+    MockKeyMatrix keys(MATRIX_ROWS, 4, MATRIX_COLS, 4);
+    CtrlEventQueueT<8> queue;
+    CtrlBtnMatrix<4, 4> matrix(MATRIX_ROWS, MATRIX_COLS, TEST_DEBOUNCE, recordMatrixPress);
+    matrix.setEventQueue(&queue, 7);
+    matrix.process();
+
+    keys.setKey(1, 3, true);
+    scanMatrix(matrix, 4);
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    CtrlEvent event;
+    TEST_ASSERT_TRUE(queue.pop(event));
+    TEST_ASSERT_EQUAL(CtrlEvent::PRESS, event.type);
+    TEST_ASSERT_EQUAL_INT(7, event.source);
+    TEST_ASSERT_EQUAL_INT(1 * 4 + 3, event.value);
+}
+
+void run_button_matrix_tests()
+{
+    RUN_TEST(test_button_matrix_press_and_release);
+    RUN_TEST(test_button_matrix_scans_once_per_interval);
+    RUN_TEST(test_button_matrix_bounce_restarts_count);
+    RUN_TEST(test_button_matrix_suppresses_ghosts);
+    RUN_TEST(test_button_matrix_without_ghost_detection);
+    RUN_TEST(test_button_matrix_columns_on_source);
+    RUN_TEST(test_button_matrix_events_to_queue);
+}
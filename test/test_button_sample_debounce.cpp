@@ -0,0 +1,119 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "CtrlBtn.h"
+#include "test_globals.h"
+
+static void test_button_sample_debounce_presses_after_samples()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.setDebounceSamples(4);
+
+    button.process();
+
+    // No time passes: only the number of samples counts.
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    for (int i = 0; i < 3; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_TRUE(button.isPressed());
+
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    for (int i = 0; i < 3; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_TRUE(button.isReleased());
+}
+
+static void test_button_sample_debounce_integrates_bounces()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.setDebounceSamples(4);
+
+    button.process();
+
+    // Down 2, up 1: the count climbs by 1 every 3 samples.
+    for (int i = 0; i < 6; ++i) {
+        _mock_digital_pins()[BTN_PIN] = i % 3 == 2 ? HIGH : LOW;
+        button.process();
+    }
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+}
+
+static void test_button_sample_debounce_reads_no_clock_while_stable()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    button.setDebounceSamples(4);
+
+    button.process();
+
+    _mock_millis_call_count() = 0;
+    for (int i = 0; i < 100; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(0, _mock_millis_call_count());
+
+    // One read when the count leaves its rest, one for the press.
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    for (int i = 0; i < 100; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(2, _mock_millis_call_count());
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_button_sample_debounce_delayed_release()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE,
+        []{ tracker.recordPress(); },
+        []{ tracker.recordRelease(); },
+        []{ tracker.recordDelayedRelease(); }
+    );
+    button.setDebounceSamples(2);
+    button.setDelayedReleaseDuration(100);
+
+    button.process();
+
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+
+    delay(101);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.delayedReleaseCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+}
+
+static void test_button_sample_debounce_can_be_turned_off()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    button.setDebounceSamples(4);
+    button.setDebounceSamples(0);
+
+    button.process();
+
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    for (int i = 0; i < 10; ++i) button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+void run_button_sample_debounce_tests()
+{
+    RUN_TEST(test_button_sample_debounce_presses_after_samples);
+    RUN_TEST(test_button_sample_debounce_integrates_bounces);
+    RUN_TEST(test_button_sample_debounce_reads_no_clock_while_stable);
+    RUN_TEST(test_button_sample_debounce_delayed_release);
+    RUN_TEST(test_button_sample_debounce_can_be_turned_off);
+}
@@ -0,0 +1,154 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlClock.h>
+#include <CtrlGroup.h>
+#include <CtrlMux.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static unsigned long simulatedMillis = 0;
+static unsigned long simulatedMicros = 0;
+static unsigned long clockReads = 0;
+
+static unsigned long simulatedMillisSource()
+{
+    ++clockReads;
+    return simulatedMillis;
+}
+
+static unsigned long simulatedMicrosSource()
+{
+    return simulatedMicros;
+}
+
+static void resetSimulatedClock()
+{
+    simulatedMillis = 0;
+    simulatedMicros = 0;
+    clockReads = 0;
+    CtrlClock::setSource(simulatedMillisSource, simulatedMicrosSource);
+}
+
+static void test_clock_reads_live_outside_a_pass()
+{
+    resetSimulatedClock();
+
+    simulatedMillis = 42;
+    TEST_ASSERT_FALSE(CtrlClock::isLatched());
+    TEST_ASSERT_EQUAL_UINT32(42, CtrlClock::now());
+    simulatedMillis = 43;
+    TEST_ASSERT_EQUAL_UINT32(43, CtrlClock::now());
+}
+
+static void test_clock_latches_nested_passes()
+{
+    resetSimulatedClock();
+
+    simulatedMillis = 10;
+    {
+        const CtrlClock::Pass outer;
+        simulatedMillis = 20;
+        {
+            const CtrlClock::Pass inner;
+            TEST_ASSERT_EQUAL_UINT32(10, CtrlClock::now());
+        }
+        TEST_ASSERT_TRUE(CtrlClock::isLatched());
+        TEST_ASSERT_EQUAL_UINT32(10, CtrlClock::now());
+        // Interrupts always see the running clock.
+        TEST_ASSERT_EQUAL_UINT32(20, CtrlClock::live());
+    }
+    TEST_ASSERT_FALSE(CtrlClock::isLatched());
+    TEST_ASSERT_EQUAL_UINT32(20, CtrlClock::now());
+}
+
+static void test_clock_numbers_outermost_passes()
+{
+    TEST_ASSERT_EQUAL_UINT32(0, CtrlClock::getPass());
+    uint16_t first;
+    {
+        const CtrlClock::Pass outer;
+        first = CtrlClock::getPass();
+        TEST_ASSERT_TRUE(first != 0);
+        const CtrlClock::Pass inner;
+        TEST_ASSERT_EQUAL_UINT32(first, CtrlClock::getPass());
+    }
+    const CtrlClock::Pass next;
+    TEST_ASSERT_TRUE(CtrlClock::getPass() != first);
+}
+
+static void test_clock_group_pass_reads_clock_once()
+{
+    CtrlGroup group;
+    CtrlBtn buttons[16] = {
+        {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE},
+        {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE},
+        {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE},
+        {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}
+    };
+    for (auto& button : buttons) group.addObject(&button);
+    group.setIdleScan(1000);
+
+    resetSimulatedClock();
+    group.process();
+    TEST_ASSERT_EQUAL_UINT32(1, clockReads);
+
+    group.process(4);
+    TEST_ASSERT_EQUAL_UINT32(2, clockReads);
+    TEST_ASSERT_FALSE(CtrlClock::isLatched());
+}
+
+static void test_clock_mux_pass_reads_clock_once()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    resetSimulatedClock();
+    mux.process();
+    mux.processFor(1000);
+    TEST_ASSERT_EQUAL_UINT32(2, clockReads);
+}
+
+static void test_clock_simulated_time_drives_debounce()
+{
+    resetSimulatedClock();
+
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn button(5, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    for (int i = 0; i < 100; ++i) mux.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    simulatedMillis += TEST_DEBOUNCE;
+    mux.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_clock_simulated_micros_drive_time_budget()
+{
+    resetSimulatedClock();
+
+    CtrlGroup group;
+    CtrlBtn buttons[4] = {{BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}, {BTN_PIN, TEST_DEBOUNCE}};
+    for (auto& button : buttons) group.addObject(&button);
+
+    // A frozen microsecond clock: every object seems to take no time at all.
+    TEST_ASSERT_EQUAL_UINT32(4, group.processFor(1));
+    TEST_ASSERT_EQUAL_UINT32(4, group.processFor(1));
+}
+
+void run_clock_tests()
+{
+    RUN_TEST(test_clock_reads_live_outside_a_pass);
+    RUN_TEST(test_clock_latches_nested_passes);
+    RUN_TEST(test_clock_numbers_outermost_passes);
+    RUN_TEST(test_clock_group_pass_reads_clock_once);
+    RUN_TEST(test_clock_mux_pass_reads_clock_once);
+    RUN_TEST(test_clock_simulated_time_drives_debounce);
+    RUN_TEST(test_clock_simulated_micros_drive_time_budget);
+}
@@ -0,0 +1,166 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlEnc.h>
+#include <CtrlEventQueue.h>
+#include <CtrlGroup.h>
+#include <CtrlPot.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static CtrlEventQueue* isrQueue = nullptr;
+
+static void test_event_queue_keeps_order_and_wraps()
+{
+    CtrlEventQueueT<4> queue;
+    CtrlEvent event;
+
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_EQUAL_UINT8(4, queue.getCapacity());
+
+    // Many more events than the capacity pass through, the indices wrap.
+    for (int i = 0; i < 1000; ++i) {
+        event.value = static_cast<int16_t>(i);
+        TEST_ASSERT_TRUE(queue.push(event));
+        event.value = static_cast<int16_t>(i + 1000);
+        TEST_ASSERT_TRUE(queue.push(event));
+        TEST_ASSERT_EQUAL_UINT8(2, queue.available());
+        TEST_ASSERT_TRUE(queue.pop(event));
+        TEST_ASSERT_EQUAL_INT(i, event.value);
+        TEST_ASSERT_TRUE(queue.pop(event));
+        TEST_ASSERT_EQUAL_INT(i + 1000, event.value);
+    }
+    TEST_ASSERT_FALSE(queue.pop(event));
+}
+
+static void test_event_queue_drops_when_full()
+{
+    CtrlEventQueueT<4> queue;
+    CtrlEvent event;
+
+    for (int i = 0; i < 6; ++i) {
+        event.value = static_cast<int16_t>(i);
+        queue.push(event);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(4, queue.available());
+    TEST_ASSERT_EQUAL_UINT16(2, queue.getDropped());
+    // The oldest events are kept.
+    TEST_ASSERT_TRUE(queue.pop(event));
+    TEST_ASSERT_EQUAL_INT(0, event.value);
+
+    queue.clear();
+    TEST_ASSERT_TRUE(queue.isEmpty());
+}
+
+static void test_event_queue_button_pushes_instead_of_callbacks()
+{
+    CtrlEventQueueT<8> queue;
+    CtrlGroup group;
+    group.setOnPress([](Groupable&){ tracker.recordPress(); });
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    group.addObject(&button);
+    button.setEventQueue(&queue, 7);
+
+    button.process();
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    CtrlEvent event;
+    TEST_ASSERT_TRUE(queue.pop(event));
+    TEST_ASSERT_EQUAL_UINT8(7, event.source);
+    TEST_ASSERT_EQUAL(CtrlEvent::PRESS, event.type);
+    TEST_ASSERT_EQUAL_UINT32(millis(), event.time);
+
+    // Held for the delayed release duration: told apart without a callback.
+    delay(500);
+    _mock_digital_pins()[BTN_PIN] = HIGH;
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+
+    TEST_ASSERT_TRUE(queue.pop(event));
+    TEST_ASSERT_EQUAL(CtrlEvent::DELAYED_RELEASE, event.type);
+    TEST_ASSERT_TRUE(queue.isEmpty());
+
+    // Back to the callbacks.
+    button.setEventQueue(nullptr);
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(2, tracker.pressCount);
+}
+
+static void test_event_queue_encoder_and_potentiometer()
+{
+    CtrlEventQueueT<8> queue;
+    CtrlEnc encoder(ENC_CLK_PIN, ENC_DT_PIN, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); });
+    CtrlPot potentiometer(POT_PIN, 100, TEST_SENSITIVITY, [](int){ tracker.recordValueChange(0); });
+    encoder.setEventQueue(&queue, 1);
+    potentiometer.setEventQueue(&queue, 2);
+
+    encoder.process();
+    _mock_digital_pins()[ENC_CLK_PIN] = HIGH;
+    encoder.process();
+    _mock_digital_pins()[ENC_DT_PIN] = HIGH;
+    encoder.process();
+
+    CtrlEvent event;
+    TEST_ASSERT_TRUE(queue.pop(event));
+    TEST_ASSERT_EQUAL_UINT8(1, event.source);
+    TEST_ASSERT_EQUAL(CtrlEvent::TURN_RIGHT, event.type);
+
+    _mock_analog_pins()[POT_PIN] = 1023;
+    for (int i = 0; i < 200; ++i) potentiometer.process();
+
+    int last = -1;
+    while (queue.pop(event)) {
+        TEST_ASSERT_EQUAL_UINT8(2, event.source);
+        TEST_ASSERT_EQUAL(CtrlEvent::VALUE_CHANGE, event.type);
+        last = event.value;
+    }
+    TEST_ASSERT_EQUAL_INT(potentiometer.getValue(), last);
+    TEST_ASSERT_EQUAL_INT(0, tracker.eventCount);
+}
+
+static void test_event_queue_accepts_interrupt_producer()
+{
+    CtrlEventQueueT<16> queue;
+    isrQueue = &queue;
+    attachInterrupt(digitalPinToInterrupt(BTN_PIN), []{
+        CtrlEvent event;
+        event.type = CtrlEvent::PRESS;
+        event.value = static_cast<int16_t>(digitalRead(BTN_PIN));
+        isrQueue->push(event);
+    }, CHANGE);
+
+    // The consumer pops between interrupts.
+    CtrlEvent event;
+    int popped = 0;
+    for (int i = 0; i < 40; ++i) {
+        _mock_pin_change(BTN_PIN, i % 2 == 0 ? LOW : HIGH);
+        if (i % 3 == 0) {
+            while (queue.pop(event)) {
+                TEST_ASSERT_EQUAL_INT(popped % 2 == 0 ? LOW : HIGH, event.value);
+                ++popped;
+            }
+        }
+    }
+    while (queue.pop(event)) ++popped;
+
+    TEST_ASSERT_EQUAL_INT(40, popped);
+    detachInterrupt(digitalPinToInterrupt(BTN_PIN));
+    isrQueue = nullptr;
+}
+
+void run_event_queue_tests()
+{
+    RUN_TEST(test_event_queue_keeps_order_and_wraps);
+    RUN_TEST(test_event_queue_drops_when_full);
+    RUN_TEST(test_event_queue_button_pushes_instead_of_callbacks);
+    RUN_TEST(test_event_queue_encoder_and_potentiometer);
+    RUN_TEST(test_event_queue_accepts_interrupt_producer);
+}
@@ -0,0 +1,225 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlEnc.h>
+#include <CtrlGroup.h>
+#include <CtrlMCP23017.h>
+#include <CtrlMCP23S17.h>
+#include <MockMCP23x17.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_mcp23017_reads_both_ports_in_one_request_per_pass()
+{
+    MockMCP23x17 chip(0x20);
+    Wire.attach(&chip);
+    CtrlMCP23017 expander;
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+    CtrlBtn btnB(15, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+    CtrlEnc encoder(3, 9, nullptr, nullptr, &expander);
+
+    expander.process();
+
+    Wire.transmissionCount = 0;
+    Wire.requestCount = 0;
+    chip.gpioReadCount = 0;
+    for (int i = 0; i < 5; ++i) expander.process();
+
+    // The address pointer stays at GPIOA: one 2 byte read per pass, nothing written.
+    TEST_ASSERT_EQUAL_INT(5, Wire.requestCount);
+    TEST_ASSERT_EQUAL_INT(0, Wire.transmissionCount);
+    TEST_ASSERT_EQUAL_INT(10, chip.gpioReadCount);
+}
+
+static void test_mcp23017_reads_once_per_group_pass()
+{
+    MockMCP23x17 chip(0x20);
+    Wire.attach(&chip);
+    CtrlMCP23017 expander;
+    CtrlGroup group;
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+    CtrlBtn btnB(15, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+    CtrlEnc encoder(3, 9, nullptr, nullptr, &expander);
+    group.addObject(&btnA);
+    group.addObject(&btnB);
+    group.addObject(&encoder);
+    group.process();
+
+    Wire.requestCount = 0;
+    group.process();
+    TEST_ASSERT_EQUAL_INT(1, Wire.requestCount);
+
+    // On its own, a button sees the expander as it is now.
+    btnA.process();
+    btnA.process();
+    TEST_ASSERT_EQUAL_INT(3, Wire.requestCount);
+}
+
+static void test_mcp23017_enables_pull_ups_of_used_pins()
+{
+    MockMCP23x17 chip(0x21);
+    Wire.attach(&chip);
+    CtrlMCP23017 expander(0x21);
+
+    CtrlBtn button(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+    CtrlBtn pulledDown(4, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+    pulledDown.setPinMode(INPUT_PULLDOWN);
+    CtrlEnc encoder(8, 10, nullptr, nullptr, &expander);
+
+    expander.process();
+
+    TEST_ASSERT_EQUAL_HEX16(0x0504, chip.getPair(MockMCP23x17::GPPUA));
+    TEST_ASSERT_EQUAL_HEX16(0, chip.getPair(MockMCP23x17::GPINTENA));
+    TEST_ASSERT_EQUAL_HEX8(0x60, chip.registers[MockMCP23x17::IOCON]);
+}
+
+static void test_mcp23017_button_can_be_pressed()
+{
+    MockMCP23x17 chip(0x20);
+    Wire.attach(&chip);
+    CtrlMCP23017 expander;
+
+    CtrlBtn button(11, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); }, nullptr, &expander);
+
+    expander.process();
+
+    chip.setPin(11, LOW);
+    expander.process();
+    delay(TEST_DEBOUNCE + 1);
+    expander.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+
+    chip.setPin(11, HIGH);
+    expander.process();
+    delay(TEST_DEBOUNCE + 1);
+    expander.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_mcp23017_skips_reads_while_int_is_inactive()
+{
+    MockMCP23x17 chip(0x20, UINT8_MAX, EXPANDER_INT_PIN);
+    Wire.attach(&chip);
+    CtrlMCP23017 expander(0x20, EXPANDER_INT_PIN);
+
+    CtrlBtn button(1, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &expander);
+    CtrlBtn other(6, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+
+    expander.process();
+    TEST_ASSERT_EQUAL_HEX16(0x0042, chip.getPair(MockMCP23x17::GPINTENA));
+
+    Wire.requestCount = 0;
+    for (int i = 0; i < 10; ++i) expander.process();
+    TEST_ASSERT_EQUAL_INT(0, Wire.requestCount);
+
+    // A change asserts INT: the next pass reads, which clears it again.
+    chip.setPin(1, LOW);
+    expander.process();
+    expander.process();
+    TEST_ASSERT_EQUAL_INT(1, Wire.requestCount);
+
+    // The debounce still completes from the captured inputs.
+    delay(TEST_DEBOUNCE + 1);
+    expander.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, Wire.requestCount);
+}
+
+static void test_mcp23017_missing_device_reads_nothing()
+{
+    CtrlMCP23017 expander(0x27);
+
+    CtrlBtn button(0, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &expander);
+
+    for (int i = 0; i < 3; ++i) expander.process();
+    delay(TEST_DEBOUNCE + 1);
+    expander.process();
+
+    // Until it answers, the inputs rest at the idle level of the objects.
+    TEST_ASSERT_EQUAL_HEX16(0x0001, expander.getInputs());
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    TEST_ASSERT_FALSE(expander.readBtnSig(16, INPUT_PULLUP));
+}
+
+static void test_mcp23017_retries_config_until_acknowledged()
+{
+    MockMCP23x17 chip(0x20);
+    CtrlMCP23017 expander;
+
+    CtrlBtn button(4, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &expander);
+
+    // Powered up after the microcontroller.
+    expander.process();
+    Wire.attach(&chip);
+    chip.setPins(0xffef);
+    expander.process();
+
+    TEST_ASSERT_EQUAL_HEX8(0x60, chip.registers[MockMCP23x17::IOCON]);
+    TEST_ASSERT_EQUAL_HEX16(0x0010, chip.getPair(MockMCP23x17::GPPUA));
+    TEST_ASSERT_EQUAL_HEX16(0xffef, expander.getInputs());
+}
+
+static void test_mcp23017_late_expander_fires_no_release()
+{
+    MockMCP23x17 chip(0x20);
+    CtrlMCP23017 expander;
+
+    CtrlBtn button(4, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); }, nullptr, &expander);
+
+    // The button initializes before the expander answers: as released, not from zeroed inputs.
+    expander.process();
+    TEST_ASSERT_FALSE(button.isPressed());
+    Wire.attach(&chip);
+    expander.process();
+    delay(TEST_DEBOUNCE + 1);
+    expander.process();
+
+    TEST_ASSERT_FALSE(button.isPressed());
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.releaseCount);
+}
+
+static void test_mcp23s17_reads_both_ports_in_one_transaction()
+{
+    _mock_digital_pins()[EXPANDER_CS_PIN] = HIGH;
+    MockMCP23x17 chip(3, EXPANDER_CS_PIN);
+    MockMCP23x17 neighbour(4, EXPANDER_CS_PIN);
+    SPI.attach(&chip);
+    SPI.attach(&neighbour);
+    CtrlMCP23S17 expander(EXPANDER_CS_PIN, 3);
+
+    CtrlBtn button(12, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &expander);
+
+    expander.process();
+    TEST_ASSERT_EQUAL_HEX8(0x68, chip.registers[MockMCP23x17::IOCON]);
+    TEST_ASSERT_EQUAL_HEX16(0x1000, chip.getPair(MockMCP23x17::GPPUA));
+    TEST_ASSERT_EQUAL_HEX16(0, neighbour.getPair(MockMCP23x17::GPPUA));
+
+    SPI.transactionCount = 0;
+    chip.setPins(0xefff);
+    neighbour.setPins(0x0000);
+    expander.process();
+    delay(TEST_DEBOUNCE + 1);
+    expander.process();
+
+    TEST_ASSERT_EQUAL_INT(2, SPI.transactionCount);
+    TEST_ASSERT_EQUAL_HEX16(0xefff, expander.getInputs());
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[EXPANDER_CS_PIN]);
+}
+
+void run_expander_tests()
+{
+    RUN_TEST(test_mcp23017_reads_both_ports_in_one_request_per_pass);
+    RUN_TEST(test_mcp23017_reads_once_per_group_pass);
+    RUN_TEST(test_mcp23017_enables_pull_ups_of_used_pins);
+    RUN_TEST(test_mcp23017_button_can_be_pressed);
+    RUN_TEST(test_mcp23017_skips_reads_while_int_is_inactive);
+    RUN_TEST(test_mcp23017_missing_device_reads_nothing);
+    RUN_TEST(test_mcp23017_retries_config_until_acknowledged);
+    RUN_TEST(test_mcp23017_late_expander_fires_no_release);
+    RUN_TEST(test_mcp23s17_reads_both_ports_in_one_transaction);
+}
@@ -1,4 +1,9 @@
 #include "test_globals.h"
+#include <CtrlClock.h>
+#include <CtrlDelayMock.h>
+#include <CtrlPinIOMock.h>
+#include <SPI.h>
+#include <Wire.h>
 
 TestTracker tracker;
 
@@ -6,8 +11,14 @@ void resetAllMocks()
 {
     tracker.reset();
     _mock_millis_ref() = 0;
+    _mock_millis_call_count() = 0;
+    CtrlClock::setSource();
     _mock_micros_ref() = 0;
     _mock_reset_pins();
+    _mock_reset_pin_io();
+    _mock_reset_delay();
+    Wire.reset();
+    SPI.reset();
     _mock_digital_pins()[BTN_PIN] = HIGH;
     _mock_digital_pins()[ENC_CLK_PIN] = LOW;
     _mock_digital_pins()[ENC_DT_PIN] = LOW;
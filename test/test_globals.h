@@ -16,6 +16,13 @@ static constexpr uint8_t MUX_S1_PIN = 12;
 static constexpr uint8_t MUX_S2_PIN = 13;
 static constexpr uint8_t MUX_S3_PIN = 14;
 
+static constexpr uint8_t SHIFT_DATA_PIN = 15;
+static constexpr uint8_t SHIFT_CLOCK_PIN = 16;
+static constexpr uint8_t SHIFT_LATCH_PIN = 17;
+static constexpr uint8_t EXPANDER_INT_PIN = 18;
+static constexpr uint8_t EXPANDER_CS_PIN = 19;
+static constexpr uint8_t ADC_CS_PIN = 20;
+
 enum class TestEvent : uint8_t {
     None,
     ButtonPressed,
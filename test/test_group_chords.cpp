@@ -0,0 +1,296 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "CtrlGroup.h"
+#include "CtrlBtn.h"
+#include "CtrlEventQueue.h"
+#include "test_globals.h"
+
+static constexpr uint8_t CHORD_PIN_A = 6;
+static constexpr uint8_t CHORD_PIN_B = 7;
+static constexpr uint8_t CHORD_PIN_C = 8;
+
+static uint32_t chordMasks[4];
+static int chordCount;
+
+static void resetChords()
+{
+    chordCount = 0;
+    for (uint32_t& mask : chordMasks) mask = 0;
+    _mock_digital_pins()[CHORD_PIN_A] = HIGH;
+    _mock_digital_pins()[CHORD_PIN_B] = HIGH;
+    _mock_digital_pins()[CHORD_PIN_C] = HIGH;
+}
+
+static void recordChord(const uint32_t mask)
+{
+    if (chordCount < 4) chordMasks[chordCount] = mask;
+    ++chordCount;
+}
+
+static void settleGroup(CtrlGroup& group)
+{
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    group.process();
+}
+
+static void test_group_masks_are_stable()
+{
+    resetChords();
+    CtrlGroup group;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE);
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE);
+    CtrlBtn c(CHORD_PIN_C, TEST_DEBOUNCE);
+    group.addObject(&a);
+    group.addObject(&b);
+    group.addObject(&c);
+
+    TEST_ASSERT_EQUAL_UINT32(0x1, group.getMask(a));
+    TEST_ASSERT_EQUAL_UINT32(0x2, group.getMask(b));
+    TEST_ASSERT_EQUAL_UINT32(0x4, group.getMask(c));
+
+    // Removing an object frees its bit, the others keep theirs.
+    group.removeObject(&a);
+    TEST_ASSERT_EQUAL_UINT32(0, group.getMask(a));
+    TEST_ASSERT_EQUAL_UINT32(0x2, group.getMask(b));
+    TEST_ASSERT_EQUAL_UINT32(0x4, group.getMask(c));
+    group.addObject(&a);
+    TEST_ASSERT_EQUAL_UINT32(0x1, group.getMask(a));
+}
+
+static void test_group_tracks_pressed_mask()
+{
+    resetChords();
+    CtrlGroup group;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE);
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE);
+    group.addObject(&a);
+    group.addObject(&b);
+    group.process();
+
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(group.getMask(b), group.getPressedMask());
+
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(group.getMask(a) | group.getMask(b), group.getPressedMask());
+
+    _mock_digital_pins()[CHORD_PIN_B] = HIGH;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(group.getMask(a), group.getPressedMask());
+
+    group.removeObject(&a);
+    TEST_ASSERT_EQUAL_UINT32(0, group.getPressedMask());
+}
+
+static void test_group_chord_fires_on_exact_match()
+{
+    resetChords();
+    CtrlGroup group;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    CtrlBtn c(CHORD_PIN_C, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    group.addObject(&a);
+    group.addObject(&b);
+    group.addObject(&c);
+    const uint32_t ab = group.getMask(a) | group.getMask(b);
+    TEST_ASSERT_TRUE(group.addChord(ab));
+    group.setChordWindow(0);
+    group.setOnChord(recordChord);
+    group.process();
+
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_INT(0, chordCount);
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+    TEST_ASSERT_EQUAL_UINT32(ab, chordMasks[0]);
+    TEST_ASSERT_EQUAL_INT(2, tracker.pressCount); // The presses still fire.
+
+    // A, B & C is not the chord.
+    _mock_digital_pins()[CHORD_PIN_C] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+}
+
+static void test_group_chord_window()
+{
+    resetChords();
+    CtrlGroup group;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE);
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE);
+    group.addObject(&a);
+    group.addObject(&b);
+    group.addChord(group.getMask(a) | group.getMask(b));
+    group.setChordWindow(30);
+    group.setOnChord(recordChord);
+    group.process();
+
+    // Too far apart.
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    settleGroup(group);
+    delay(50);
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_INT(0, chordCount);
+
+    _mock_digital_pins()[CHORD_PIN_A] = HIGH;
+    _mock_digital_pins()[CHORD_PIN_B] = HIGH;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(0, group.getPressedMask());
+
+    // Together.
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    group.process();
+    delay(5);
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    group.process();
+    delay(5);
+    group.process();
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+}
+
+static void test_group_chord_table_grows()
+{
+    resetChords();
+    CtrlGroup group;
+    for (uint32_t mask = 1; mask <= 40; ++mask) {
+        TEST_ASSERT_TRUE(group.addChord(mask * 3));
+    }
+    TEST_ASSERT_TRUE(group.addChord(3)); // Already there.
+
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE);
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE);
+    group.addObject(&a);
+    group.addObject(&b);
+    group.setOnChord(recordChord);
+    group.process();
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+    TEST_ASSERT_EQUAL_UINT32(3, chordMasks[0]);
+
+    group.clearChords();
+    _mock_digital_pins()[CHORD_PIN_A] = HIGH;
+    settleGroup(group);
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+}
+
+static void test_group_chord_with_event_queue()
+{
+    resetChords();
+    CtrlGroup group;
+    CtrlEventQueueT<8> queue;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    a.setEventQueue(&queue, 1);
+    b.setEventQueue(&queue, 2);
+    group.addObject(&a);
+    group.addObject(&b);
+    const uint32_t ab = group.getMask(a) | group.getMask(b);
+    group.addChord(ab);
+    group.setOnChord(recordChord);
+    group.process();
+
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(ab, group.getPressedMask());
+    // The presses and the chord all went to the queue, the chord last.
+    TEST_ASSERT_EQUAL_INT(0, chordCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(3, queue.available());
+    CtrlEvent event;
+    queue.pop(event);
+    TEST_ASSERT_EQUAL_INT(CtrlEvent::PRESS, event.type);
+    TEST_ASSERT_EQUAL_INT(1, event.source);
+    queue.pop(event);
+    TEST_ASSERT_EQUAL_INT(CtrlEvent::PRESS, event.type);
+    TEST_ASSERT_EQUAL_INT(2, event.source);
+    queue.pop(event);
+    TEST_ASSERT_EQUAL_INT(CtrlEvent::CHORD, event.type);
+    TEST_ASSERT_EQUAL_INT(2, event.source);
+    TEST_ASSERT_EQUAL_UINT32(ab, static_cast<uint32_t>(event.value));
+
+    _mock_digital_pins()[CHORD_PIN_A] = HIGH;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(group.getMask(b), group.getPressedMask());
+}
+
+static char callbackOrder[8];
+static uint8_t callbackCount;
+
+static void recordCallback(const char callback)
+{
+    if (callbackCount < sizeof(callbackOrder) - 1) callbackOrder[callbackCount++] = callback;
+}
+
+static void test_group_chord_with_two_phase_scan()
+{
+    resetChords();
+    callbackCount = 0;
+    for (char& callback : callbackOrder) callback = 0;
+    CtrlGroup group;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE, []{ recordCallback('a'); });
+    CtrlBtn b(CHORD_PIN_B, TEST_DEBOUNCE, []{ recordCallback('b'); });
+    group.addObject(&a);
+    group.addObject(&b);
+    const uint32_t ab = group.getMask(a) | group.getMask(b);
+    group.addChord(ab);
+    group.setOnChord([](uint32_t mask){ recordChord(mask); recordCallback('c'); });
+    TEST_ASSERT_TRUE(group.setTwoPhaseScan(true));
+    group.process();
+
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    _mock_digital_pins()[CHORD_PIN_B] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(ab, group.getPressedMask());
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+    TEST_ASSERT_EQUAL_UINT32(ab, chordMasks[0]);
+    // Held back until the pass ends, then fired in order: the chord after both presses.
+    TEST_ASSERT_EQUAL_STRING("abc", callbackOrder);
+
+    // The events fire once: no second chord.
+    group.process();
+    TEST_ASSERT_EQUAL_INT(1, chordCount);
+}
+
+static void test_group_disabled_button_resyncs_released()
+{
+    resetChords();
+    CtrlGroup group;
+    CtrlBtn a(CHORD_PIN_A, TEST_DEBOUNCE);
+    group.addObject(&a);
+    group.process();
+
+    _mock_digital_pins()[CHORD_PIN_A] = LOW;
+    settleGroup(group);
+    TEST_ASSERT_EQUAL_UINT32(group.getMask(a), group.getPressedMask());
+
+    a.disable();
+    group.process();
+    _mock_digital_pins()[CHORD_PIN_A] = HIGH;
+    a.enable();
+    group.process();
+    TEST_ASSERT_TRUE(a.isReleased());
+    TEST_ASSERT_EQUAL_UINT32(0, group.getPressedMask());
+}
+
+void run_group_chord_tests()
+{
+    RUN_TEST(test_group_masks_are_stable);
+    RUN_TEST(test_group_tracks_pressed_mask);
+    RUN_TEST(test_group_chord_fires_on_exact_match);
+    RUN_TEST(test_group_chord_window);
+    RUN_TEST(test_group_chord_table_grows);
+    RUN_TEST(test_group_chord_with_event_queue);
+    RUN_TEST(test_group_chord_with_two_phase_scan);
+    RUN_TEST(test_group_disabled_button_resyncs_released);
+}
@@ -0,0 +1,151 @@
+#include <Arduino.h>
+#include <CtrlBase.h>
+#include <CtrlBtn.h>
+#include <CtrlGroup.h>
+#include <CtrlMux.h>
+#include <CtrlPinIOMock.h>
+#include <unity.h>
+#include "test_globals.h"
+
+class ActivityObject : public CtrlBase, public Muxable, public Groupable
+{
+    public:
+        int processCount = 0;
+        bool changing = false;
+
+        explicit ActivityObject(CtrlSource* mux = nullptr) : Muxable(mux) { }
+
+        void process() override
+        {
+            ++this->processCount;
+            if (this->changing) this->markActivity(millis());
+        }
+
+        [[nodiscard]] uint8_t getScanPriority() const override { return this->priority; }
+
+        [[nodiscard]] bool isScanIdle(const unsigned long now, const unsigned long timeout) const override
+        {
+            return this->isIdleFor(now, timeout);
+        }
+};
+
+static void test_mux_idle_objects_scanned_at_slow_rate()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setIdleScan(100, 4);
+    ActivityObject objects[8];
+    for (auto& object : objects) object.setMultiplexer(&mux);
+
+    delay(100);
+    for (int i = 0; i < 8; ++i) mux.process();
+
+    // Every idle object gets 1 out of 4 turns.
+    for (auto& object : objects) TEST_ASSERT_EQUAL_INT(2, object.processCount);
+}
+
+static void test_mux_recently_active_objects_scanned_every_pass()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setIdleScan(100, 4);
+    ActivityObject idle;
+    ActivityObject active;
+    idle.setMultiplexer(&mux);
+    active.setMultiplexer(&mux);
+
+    delay(100);
+    active.changing = true;
+    for (int i = 0; i < 4; ++i) mux.process();
+    const int promoted = active.processCount;
+    for (int i = 0; i < 8; ++i) mux.process();
+
+    // Promoted on the first turn that saw the change, on every pass from then on.
+    TEST_ASSERT_EQUAL_INT(promoted + 8, active.processCount);
+    TEST_ASSERT_EQUAL_INT(3, idle.processCount);
+
+    // Back to the slow rate once the timeout passes without changes.
+    active.changing = false;
+    delay(100);
+    active.processCount = 0;
+    for (int i = 0; i < 8; ++i) mux.process();
+    TEST_ASSERT_EQUAL_INT(2, active.processCount);
+}
+
+static void test_mux_idle_scan_disabled_by_default()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    ActivityObject object(&mux);
+
+    delay(1000);
+    for (int i = 0; i < 8; ++i) mux.process();
+
+    TEST_ASSERT_EQUAL_INT(8, object.processCount);
+}
+
+static void test_mux_idle_scan_skips_only_normal_priority()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setIdleScan(100, 4);
+    ActivityObject high(&mux);
+    high.setPriority(CtrlBase::PRIORITY_HIGH);
+    ActivityObject normals[3];
+    for (auto& object : normals) object.setMultiplexer(&mux);
+
+    delay(100);
+    for (int i = 0; i < 8; ++i) mux.process(2);
+
+    TEST_ASSERT_EQUAL_INT(8, high.processCount);
+    // The idle objects still get only 1 out of 4 turns, however many slots are left.
+    for (auto& object : normals) TEST_ASSERT_EQUAL_INT(2, object.processCount);
+}
+
+static void test_mux_pressed_button_promotes_to_full_rate()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setIdleScan(100, 8);
+    CtrlBtn button(3, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); }, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+    delay(100);
+
+    _mock_reset_pin_io();
+    for (int i = 0; i < 8; ++i) mux.process();
+    TEST_ASSERT_EQUAL_INT(1, _mock_pin_read_count());
+
+    // Seen within one idle interval, then debounced at full rate.
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    for (int i = 0; i < 8; ++i) mux.process();
+    _mock_reset_pin_io();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, _mock_pin_read_count());
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_group_idle_objects_scanned_at_slow_rate()
+{
+    CtrlGroup group;
+    group.setIdleScan(50, 2);
+    ActivityObject idle;
+    ActivityObject active;
+    idle.setGroup(&group);
+    active.setGroup(&group);
+    active.changing = true;
+
+    delay(50);
+    for (int i = 0; i < 8; ++i) group.process();
+
+    TEST_ASSERT_EQUAL_INT(4, idle.processCount);
+    TEST_ASSERT_TRUE(active.processCount >= 7);
+}
+
+void run_idle_scan_tests()
+{
+    RUN_TEST(test_mux_idle_objects_scanned_at_slow_rate);
+    RUN_TEST(test_mux_recently_active_objects_scanned_every_pass);
+    RUN_TEST(test_mux_idle_scan_disabled_by_default);
+    RUN_TEST(test_mux_idle_scan_skips_only_normal_priority);
+    RUN_TEST(test_mux_pressed_button_promotes_to_full_rate);
+    RUN_TEST(test_group_idle_objects_scanned_at_slow_rate);
+}
@@ -518,6 +518,81 @@ static void test_group_destroyed_before_objects_no_crash()
     TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
 }
 
+class CountingGroupable : public Groupable
+{
+    public:
+        int processCount = 0;
+        void process() override { ++this->processCount; }
+};
+
+class CountingMuxable : public Muxable
+{
+    public:
+        int processCount = 0;
+        explicit CountingMuxable(CtrlMux* mux = nullptr) : Muxable(mux) { }
+        void process() override { ++this->processCount; }
+};
+
+static void test_group_remove_keeps_round_robin_fair()
+{
+    CtrlGroup group;
+    CountingGroupable a, b, c, d;
+    a.setGroup(&group);
+    b.setGroup(&group);
+    c.setGroup(&group);
+    d.setGroup(&group);
+
+    group.process(2);
+    b.setGroup(nullptr);
+    group.process(2);
+
+    // c & d were still waiting for their turn, a was already processed.
+    TEST_ASSERT_EQUAL_INT(1, a.processCount);
+    TEST_ASSERT_EQUAL_INT(1, c.processCount);
+    TEST_ASSERT_EQUAL_INT(1, d.processCount);
+
+    group.process(1);
+    TEST_ASSERT_EQUAL_INT(2, a.processCount);
+}
+
+static void test_group_remove_and_re_add_objects()
+{
+    CtrlGroup group;
+    CountingGroupable objects[6];
+    for (auto& object : objects) object.setGroup(&group);
+
+    objects[1].setGroup(nullptr);
+    objects[4].setGroup(nullptr);
+    objects[1].setGroup(nullptr);
+    TEST_ASSERT_TRUE(objects[1].setGroup(&group));
+    TEST_ASSERT_TRUE(objects[1].setGroup(&group));
+
+    group.process();
+
+    for (uint8_t i = 0; i < 6; ++i) {
+        TEST_ASSERT_EQUAL_INT(i == 4 ? 0 : 1, objects[i].processCount);
+    }
+}
+
+static void test_mux_remove_keeps_round_robin_fair()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CountingMuxable a(&mux), b(&mux), c(&mux), d(&mux);
+
+    mux.process(2);
+    b.setMultiplexer(nullptr);
+    mux.process(2);
+
+    TEST_ASSERT_EQUAL_INT(1, a.processCount);
+    TEST_ASSERT_EQUAL_INT(1, c.processCount);
+    TEST_ASSERT_EQUAL_INT(1, d.processCount);
+
+    TEST_ASSERT_TRUE(b.setMultiplexer(&mux));
+    mux.process();
+    TEST_ASSERT_EQUAL_INT(2, b.processCount);
+    TEST_ASSERT_EQUAL_INT(2, d.processCount);
+}
+
 void run_interaction_tests()
 {
     RUN_TEST(test_two_buttons_in_group_independent_events);
@@ -542,4 +617,7 @@ void run_interaction_tests()
     RUN_TEST(test_group_object_destroyed_unregisters);
     RUN_TEST(test_mux_destroyed_before_objects_no_crash);
     RUN_TEST(test_group_destroyed_before_objects_no_crash);
+    RUN_TEST(test_group_remove_keeps_round_robin_fair);
+    RUN_TEST(test_group_remove_and_re_add_objects);
+    RUN_TEST(test_mux_remove_keeps_round_robin_fair);
 }
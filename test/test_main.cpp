@@ -9,6 +9,8 @@ extern void run_button_advanced_tests();
 extern void run_button_pull_down_tests();
 extern void run_button_pull_up_tests();
 extern void run_button_delayed_release_tests();
+extern void run_button_sample_debounce_tests();
+extern void run_button_leading_edge_tests();
 
 extern void run_encoder_common_tests();
 extern void run_encoder_basic_tests();
@@ -24,17 +26,40 @@ extern void run_potentiometer_advanced_tests();
 
 extern void run_led_tests();
 
+extern void run_pin_io_tests();
+extern void run_pin_interrupt_tests();
+extern void run_button_edge_capture_tests();
+extern void run_button_gesture_tests();
+
 extern void run_multiplexer_button_tests();
 extern void run_multiplexer_encoder_tests();
 extern void run_multiplexer_potentiometer_tests();
+extern void run_multiplexer_scan_plan_tests();
+extern void run_multiplexer_bus_tests();
+extern void run_multiplexer_snapshot_tests();
+extern void run_multiplexer_pipelined_tests();
+extern void run_multiplexer_settle_tests();
+extern void run_multiplexer_static_tests();
+extern void run_shift_in_tests();
+extern void run_expander_tests();
+extern void run_spi_adc_tests();
+extern void run_button_bank_tests();
+extern void run_button_matrix_tests();
 
 extern void run_group_button_tests();
+extern void run_group_chord_tests();
 extern void run_group_encoder_tests();
 extern void run_group_potentiometer_tests();
 
 extern void run_groupable_metadata_tests();
 
 extern void run_interaction_tests();
+extern void run_scan_priority_tests();
+extern void run_time_budget_tests();
+extern void run_idle_scan_tests();
+extern void run_clock_tests();
+extern void run_event_queue_tests();
+extern void run_two_phase_scan_tests();
 
 void setUp(void)
 {
@@ -56,6 +81,8 @@ int run_tests()
     run_button_pull_down_tests();
     run_button_pull_up_tests();
     run_button_delayed_release_tests();
+    run_button_sample_debounce_tests();
+    run_button_leading_edge_tests();
 
     run_encoder_common_tests();
     run_encoder_basic_tests();
@@ -71,17 +98,40 @@ int run_tests()
 
     run_led_tests();
 
+    run_pin_io_tests();
+    run_pin_interrupt_tests();
+    run_button_edge_capture_tests();
+    run_button_gesture_tests();
+
     run_multiplexer_button_tests();
     run_multiplexer_encoder_tests();
     run_multiplexer_potentiometer_tests();
+    run_multiplexer_scan_plan_tests();
+    run_multiplexer_bus_tests();
+    run_multiplexer_snapshot_tests();
+    run_multiplexer_pipelined_tests();
+    run_multiplexer_settle_tests();
+    run_multiplexer_static_tests();
+    run_shift_in_tests();
+    run_expander_tests();
+    run_spi_adc_tests();
+    run_button_bank_tests();
+    run_button_matrix_tests();
 
     run_group_button_tests();
+    run_group_chord_tests();
     run_group_encoder_tests();
     run_group_potentiometer_tests();
 
     run_groupable_metadata_tests();
 
     run_interaction_tests();
+    run_scan_priority_tests();
+    run_time_budget_tests();
+    run_idle_scan_tests();
+    run_clock_tests();
+    run_event_queue_tests();
+    run_two_phase_scan_tests();
 
     return UNITY_END();
 }
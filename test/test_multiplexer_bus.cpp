@@ -0,0 +1,138 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlEnc.h>
+#include <CtrlMux.h>
+#include <CtrlMuxBus.h>
+#include <CtrlPot.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static constexpr uint8_t MUX_B_SIG_PIN = 6;
+static constexpr uint8_t MUX_C_SIG_PIN = 7;
+
+static void test_mux_bus_processes_all_muxes()
+{
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux btnMux(MUX_SIG_PIN, &bus);
+    CtrlMux potMux(MUX_B_SIG_PIN, &bus);
+
+    CtrlBtn button(0, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &btnMux);
+    CtrlPot potentiometer(0, 100, TEST_SENSITIVITY, nullptr, &potMux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    bus.process();
+
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    _mock_analog_pins()[MUX_B_SIG_PIN] = 1023;
+    bus.process();
+    delay(TEST_DEBOUNCE + 1);
+    bus.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_TRUE(button.isPressed());
+
+    converge(
+        [&]{ bus.process(); },
+        [&]{ return (int)potentiometer.getValue(); },
+        100
+    );
+
+    TEST_ASSERT_EQUAL_INT(100, potentiometer.getValue());
+}
+
+static void test_mux_bus_selects_each_channel_once()
+{
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux muxA(MUX_SIG_PIN, &bus);
+    CtrlMux muxB(MUX_B_SIG_PIN, &bus);
+    CtrlMux muxC(MUX_C_SIG_PIN, &bus);
+
+    CtrlBtn btnA0(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnA1(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnB0(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxB);
+    CtrlBtn btnB1(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxB);
+    CtrlBtn btnC0(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxC);
+    CtrlBtn btnC1(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxC);
+
+    bus.process();
+
+    const unsigned long writes = _mock_digital_write_count();
+    const unsigned long start = _mock_micros_ref();
+    bus.process();
+
+    // Channels 0 and 1 differ in s0 only: one write per channel for all 3 muxes.
+    TEST_ASSERT_EQUAL_INT(2, _mock_digital_write_count() - writes);
+    // One settle delay per channel.
+    TEST_ASSERT_EQUAL_INT(2, _mock_micros_ref() - start);
+}
+
+static void test_mux_bus_samples_encoder_phases_together()
+{
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux mux(MUX_SIG_PIN, &bus);
+
+    CtrlEnc encoder(0, 1, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); }, &mux);
+
+    int seq_idle[] = {LOW, LOW};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_idle, 2);
+    for (int i = 0; i < 10; ++i) bus.process();
+
+    int seq_step[] = {LOW, HIGH};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_step, 2);
+    for (int i = 0; i < 10; ++i) bus.process();
+
+    int seq_done[] = {HIGH, HIGH};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_done, 2);
+    for (int i = 0; i < 10; ++i) bus.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.turnLeftCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.turnRightCount);
+}
+
+static void test_mux_bus_mux_still_processes_on_its_own()
+{
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux mux(MUX_SIG_PIN, &bus);
+
+    CtrlBtn button(5, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S0_PIN]);
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S2_PIN]);
+}
+
+static void test_mux_bus_destroyed_before_muxes_no_crash()
+{
+    auto* bus = new CtrlMuxBus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux mux(MUX_SIG_PIN, bus);
+    CtrlBtn button(0, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+
+    delete bus;
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+void run_multiplexer_bus_tests()
+{
+    RUN_TEST(test_mux_bus_processes_all_muxes);
+    RUN_TEST(test_mux_bus_selects_each_channel_once);
+    RUN_TEST(test_mux_bus_samples_encoder_phases_together);
+    RUN_TEST(test_mux_bus_mux_still_processes_on_its_own);
+    RUN_TEST(test_mux_bus_destroyed_before_muxes_no_crash);
+}
@@ -0,0 +1,122 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlDelay.h>
+#include <CtrlEnc.h>
+#include <CtrlMux.h>
+#include <CtrlPinIOMock.h>
+#include <CtrlPot.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_mux_pipelined_selects_next_channel_before_processing()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::PIPELINED);
+
+    // Channel 1 (s0 high) is scanned right after channel 0.
+    CtrlBtn btnA(0, TEST_DEBOUNCE, []{
+        TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[MUX_S0_PIN]);
+        tracker.recordPress();
+    }, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    int seq[] = { LOW, HIGH };
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq, 2);
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_TRUE(btnA.isPressed());
+    TEST_ASSERT_TRUE(btnB.isReleased());
+}
+
+static void test_mux_pipelined_reads_each_channel_once()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::PIPELINED);
+
+    CtrlEnc encoder(4, 5, nullptr, nullptr, &mux);
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlPot potentiometer(9, 100, TEST_SENSITIVITY, nullptr, &mux);
+
+    mux.process();
+
+    _mock_reset_pin_io();
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(4, _mock_pin_read_count());
+    TEST_ASSERT_EQUAL_INT(4, _mock_select_write_count());
+}
+
+static void test_mux_pipelined_encoder_can_turn_left()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::PIPELINED);
+
+    CtrlEnc encoder(0, 1, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); }, &mux);
+
+    int seq_idle[] = {LOW, LOW};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_idle, 2);
+    for (int i = 0; i < 10; ++i) mux.process();
+
+    int seq_step[] = {LOW, HIGH};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_step, 2);
+    for (int i = 0; i < 10; ++i) mux.process();
+
+    int seq_done[] = {HIGH, HIGH};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_done, 2);
+    for (int i = 0; i < 10; ++i) mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.turnLeftCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.turnRightCount);
+}
+
+static void test_mux_pipelined_time_sliced_round_robin()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::PIPELINED);
+
+    CtrlPot potA(0, 100, TEST_SENSITIVITY, nullptr, &mux);
+    CtrlPot potB(1, 100, TEST_SENSITIVITY, nullptr, &mux);
+    CtrlPot potC(3, 100, TEST_SENSITIVITY, nullptr, &mux);
+
+    _mock_analog_pins()[MUX_SIG_PIN] = 1023;
+
+    converge(
+        [&]{ mux.process(1); },
+        [&]{ return (int)potC.getValue(); },
+        100
+    );
+
+    TEST_ASSERT_EQUAL_INT(100, potA.getValue());
+    TEST_ASSERT_EQUAL_INT(100, potB.getValue());
+    TEST_ASSERT_EQUAL_INT(100, potC.getValue());
+}
+
+static void test_mux_pipelined_reports_mode_in_use()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    TEST_ASSERT_EQUAL_INT(CtrlMux::DIRECT, mux.getScanMode());
+
+    // Without fine timestamps a pipelined scan falls back to a snapshot.
+    mux.setScanMode(CtrlMux::PIPELINED);
+    const CtrlMux::ScanMode expected = CtrlDelay::FINE_TIMESTAMPS ? CtrlMux::PIPELINED : CtrlMux::SNAPSHOT;
+    TEST_ASSERT_EQUAL_INT(expected, mux.getScanMode());
+
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+    TEST_ASSERT_EQUAL_INT(CtrlMux::SNAPSHOT, mux.getScanMode());
+}
+
+void run_multiplexer_pipelined_tests()
+{
+    RUN_TEST(test_mux_pipelined_selects_next_channel_before_processing);
+    RUN_TEST(test_mux_pipelined_reads_each_channel_once);
+    RUN_TEST(test_mux_pipelined_encoder_can_turn_left);
+    RUN_TEST(test_mux_pipelined_time_sliced_round_robin);
+    RUN_TEST(test_mux_pipelined_reports_mode_in_use);
+}
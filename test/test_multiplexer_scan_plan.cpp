@@ -0,0 +1,207 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlMux.h>
+#include <CtrlMuxBus.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_mux_scan_plan_minimizes_select_writes()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    // Registered in an order that would toggle most select lines on every read.
+    static constexpr uint8_t channels[16] = { 15, 0, 14, 1, 13, 2, 12, 3, 11, 4, 10, 5, 9, 6, 8, 7 };
+    CtrlBtn* buttons[16];
+    for (uint8_t i = 0; i < 16; ++i) {
+        buttons[i] = new CtrlBtn(channels[i], TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    }
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_digital_write_count() = 0;
+    mux.process();
+
+    // Gray-code order: one select line per channel step, plus the wrap around to the first channel.
+    TEST_ASSERT_EQUAL_INT(16, _mock_digital_write_count());
+
+    for (auto* button : buttons) delete button;
+}
+
+static void test_mux_scan_plan_groups_pin_modes()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnD(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    btnA.setPinMode(INPUT_PULLUP);
+    btnB.setPinMode(INPUT_PULLDOWN);
+    btnC.setPinMode(INPUT_PULLUP);
+    btnD.setPinMode(INPUT_PULLDOWN);
+
+    mux.process();
+
+    _mock_pin_mode_count() = 0;
+    mux.process();
+
+    // One switch into each pin mode group per pass, instead of one per object.
+    TEST_ASSERT_EQUAL_INT(2, _mock_pin_mode_count());
+}
+
+static unsigned long pinModesAtSelect = 0;
+
+static void recordPinModesAtSelect(const uint8_t pin, uint8_t)
+{
+    if (pin >= MUX_S0_PIN && pin <= MUX_S3_PIN) pinModesAtSelect = _mock_pin_mode_count();
+}
+
+static void test_mux_sweeps_group_pin_modes()
+{
+    // A sweep starts with the group of the current pin mode: one switch per pass.
+    // The pipeline follows the scan plan: one switch into each group.
+    const CtrlMux::ScanMode modes[] = { CtrlMux::SNAPSHOT, CtrlMux::PIPELINED };
+    const int switches[] = { 1, 2 };
+    for (uint8_t i = 0; i < 2; ++i) {
+        CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+        mux.setScanMode(modes[i]);
+
+        CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+        CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+        CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+        CtrlBtn btnD(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+        btnA.setPinMode(INPUT_PULLUP);
+        btnB.setPinMode(INPUT_PULLDOWN);
+        btnC.setPinMode(INPUT_PULLUP);
+        btnD.setPinMode(INPUT_PULLDOWN);
+
+        mux.process();
+        _mock_pin_mode_count() = 0;
+        mux.process();
+
+        TEST_ASSERT_EQUAL_INT(switches[i], _mock_pin_mode_count());
+    }
+}
+
+static void test_mux_pipeline_sets_pin_mode_before_select()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::PIPELINED);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    btnA.setPinMode(INPUT_PULLUP);
+    btnB.setPinMode(INPUT_PULLDOWN);
+    mux.process();
+
+    _mock_pin_mode_count() = 0;
+    const _MockDigitalWriteHook previousHook = _mock_digital_write_hook();
+    _mock_digital_write_hook() = recordPinModesAtSelect;
+    mux.process();
+    _mock_digital_write_hook() = previousHook;
+
+    // Both switches came before the select of their channel.
+    TEST_ASSERT_EQUAL_INT(2, _mock_pin_mode_count());
+    TEST_ASSERT_EQUAL_INT(2, pinModesAtSelect);
+}
+
+static void test_mux_sweep_sets_pin_mode_before_select()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    btnA.setPinMode(INPUT_PULLUP);
+    btnB.setPinMode(INPUT_PULLDOWN);
+    mux.process();
+
+    _mock_pin_mode_count() = 0;
+    const _MockDigitalWriteHook previousHook = _mock_digital_write_hook();
+    _mock_digital_write_hook() = recordPinModesAtSelect;
+    mux.process();
+    _mock_digital_write_hook() = previousHook;
+
+    // The pin mode switch came before the last channel select, so it settled with it.
+    TEST_ASSERT_EQUAL_INT(1, _mock_pin_mode_count());
+    TEST_ASSERT_EQUAL_INT(1, pinModesAtSelect);
+}
+
+static void test_mux_bus_groups_pin_modes()
+{
+    static constexpr uint8_t MUX_B_SIG_PIN = 6;
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux muxA(MUX_SIG_PIN, &bus);
+    CtrlMux muxB(MUX_B_SIG_PIN, &bus);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnD(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnE(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxB);
+    btnA.setPinMode(INPUT_PULLUP);
+    btnB.setPinMode(INPUT_PULLDOWN);
+    btnC.setPinMode(INPUT_PULLUP);
+    btnD.setPinMode(INPUT_PULLDOWN);
+
+    bus.process();
+    _mock_pin_mode_count() = 0;
+    bus.process();
+
+    TEST_ASSERT_EQUAL_INT(1, _mock_pin_mode_count());
+}
+
+static void test_mux_scan_plan_reads_correct_channels()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlBtn btnA(5, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+    CtrlBtn btnB(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    // Only pull the signal low while channel 5 is selected.
+    int seq[] = { HIGH, LOW };
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq, 2);
+
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_TRUE(btnA.isPressed());
+    TEST_ASSERT_TRUE(btnB.isReleased());
+}
+
+static void test_mux_scan_plan_shared_select_lines()
+{
+    CtrlMux muxA(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMux muxB(6, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlBtn btnA(5, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnB(10, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxB);
+
+    muxA.process();
+    muxB.process();
+    muxA.process();
+
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S0_PIN]);
+    TEST_ASSERT_EQUAL_INT(0, _mock_digital_pins()[MUX_S1_PIN]);
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S2_PIN]);
+    TEST_ASSERT_EQUAL_INT(0, _mock_digital_pins()[MUX_S3_PIN]);
+}
+
+void run_multiplexer_scan_plan_tests()
+{
+    RUN_TEST(test_mux_scan_plan_minimizes_select_writes);
+    RUN_TEST(test_mux_scan_plan_groups_pin_modes);
+    RUN_TEST(test_mux_sweeps_group_pin_modes);
+    RUN_TEST(test_mux_sweep_sets_pin_mode_before_select);
+    RUN_TEST(test_mux_pipeline_sets_pin_mode_before_select);
+    RUN_TEST(test_mux_bus_groups_pin_modes);
+    RUN_TEST(test_mux_scan_plan_reads_correct_channels);
+    RUN_TEST(test_mux_scan_plan_shared_select_lines);
+}
@@ -0,0 +1,98 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlDelay.h>
+#include <CtrlDelayMock.h>
+#include <CtrlMux.h>
+#include <CtrlMuxBus.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_nanos_to_cycles_rounds_up()
+{
+    TEST_ASSERT_EQUAL_UINT32(90, ctrlNanosToCycles(150, 600000000UL));
+    TEST_ASSERT_EQUAL_UINT32(3, ctrlNanosToCycles(150, 16000000UL));
+    TEST_ASSERT_EQUAL_UINT32(16, ctrlNanosToCycles(1000, 16000000UL));
+    TEST_ASSERT_EQUAL_UINT32(153000000UL, ctrlNanosToCycles(255000000UL, 600000000UL));
+}
+
+static void test_mux_default_switch_interval_is_one_microsecond()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn button(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    mux.process();
+
+    // The first read is done when the button initializes.
+    TEST_ASSERT_EQUAL_UINT32(2, _mock_settle_wait_count());
+    TEST_ASSERT_EQUAL_UINT32(2000, _mock_settle_waited_ns());
+}
+
+static void test_mux_switch_interval_in_nanoseconds()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setSwitchIntervalNs(150);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    mux.process();
+
+    // Initializing each button reads it once more.
+    TEST_ASSERT_EQUAL_UINT32(4, _mock_settle_wait_count());
+    TEST_ASSERT_EQUAL_UINT32(600, _mock_settle_waited_ns());
+
+    mux.setSwitchInterval(2);
+    _mock_reset_delay();
+    mux.process();
+
+    TEST_ASSERT_EQUAL_UINT32(4000, _mock_settle_waited_ns());
+}
+
+static void test_mux_pipelined_waits_only_remaining_settle_time()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::PIPELINED);
+    mux.setSwitchIntervalNs(200);
+
+    // Takes 150 ns of the settle time of the next channel.
+    CtrlBtn btnA(0, TEST_DEBOUNCE, []{ _mock_advance_nanos(150); }, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+
+    _mock_reset_delay();
+    mux.process();
+
+    TEST_ASSERT_TRUE(btnA.isPressed());
+    TEST_ASSERT_EQUAL_UINT32(2, _mock_settle_wait_count());
+    TEST_ASSERT_EQUAL_UINT32(250, _mock_settle_waited_ns());
+}
+
+static void test_mux_bus_switch_interval_in_nanoseconds()
+{
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    bus.setSwitchIntervalNs(120);
+    CtrlMux muxA(MUX_SIG_PIN, &bus);
+    CtrlMux muxB(6, &bus);
+
+    CtrlBtn btnA(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxA);
+    CtrlBtn btnB(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &muxB);
+
+    bus.process();
+
+    TEST_ASSERT_EQUAL_UINT32(1, _mock_settle_wait_count());
+    TEST_ASSERT_EQUAL_UINT32(120, _mock_settle_waited_ns());
+}
+
+void run_multiplexer_settle_tests()
+{
+    RUN_TEST(test_nanos_to_cycles_rounds_up);
+    RUN_TEST(test_mux_default_switch_interval_is_one_microsecond);
+    RUN_TEST(test_mux_switch_interval_in_nanoseconds);
+    RUN_TEST(test_mux_pipelined_waits_only_remaining_settle_time);
+    RUN_TEST(test_mux_bus_switch_interval_in_nanoseconds);
+}
@@ -0,0 +1,121 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlEnc.h>
+#include <CtrlMux.h>
+#include <CtrlPinIOMock.h>
+#include <CtrlPot.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_mux_snapshot_reads_each_channel_once()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlEnc encoder(0, 3, nullptr, nullptr, &mux);
+    CtrlBtn btnA(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    mux.process();
+
+    _mock_reset_pin_io();
+    mux.process();
+
+    // 4 used channels: 4 reads & 4 channel switches, no matter how many objects read them.
+    TEST_ASSERT_EQUAL_INT(4, _mock_pin_read_count());
+    TEST_ASSERT_EQUAL_INT(4, _mock_select_write_count());
+}
+
+static void test_mux_snapshot_button_can_be_pressed()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlBtn button(7, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); }, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_mux_snapshot_encoder_can_turn_right()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlEnc encoder(0, 1, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); }, &mux);
+
+    int seq_idle[] = {LOW, LOW};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_idle, 2);
+    for (int i = 0; i < 10; ++i) mux.process();
+
+    int seq_step[] = {HIGH, LOW};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_step, 2);
+    for (int i = 0; i < 10; ++i) mux.process();
+
+    int seq_done[] = {HIGH, HIGH};
+    _mock_set_digital_sequence(MUX_SIG_PIN, seq_done, 2);
+    for (int i = 0; i < 10; ++i) mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.turnRightCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.turnLeftCount);
+}
+
+static void test_mux_snapshot_potentiometer_converges()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlPot potentiometer(4, 100, TEST_SENSITIVITY, nullptr, &mux);
+
+    _mock_analog_pins()[MUX_SIG_PIN] = 1023;
+
+    converge(
+        [&]{ mux.process(); },
+        [&]{ return (int)potentiometer.getValue(); },
+        100
+    );
+
+    TEST_ASSERT_EQUAL_INT(100, potentiometer.getValue());
+}
+
+static void test_mux_snapshot_time_sliced_only_sweeps_serviced_channels()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    mux.setScanMode(CtrlMux::SNAPSHOT);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnD(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    mux.process();
+
+    _mock_reset_pin_io();
+    mux.process(2);
+
+    TEST_ASSERT_EQUAL_INT(2, _mock_pin_read_count());
+}
+
+void run_multiplexer_snapshot_tests()
+{
+    RUN_TEST(test_mux_snapshot_reads_each_channel_once);
+    RUN_TEST(test_mux_snapshot_button_can_be_pressed);
+    RUN_TEST(test_mux_snapshot_encoder_can_turn_right);
+    RUN_TEST(test_mux_snapshot_potentiometer_converges);
+    RUN_TEST(test_mux_snapshot_time_sliced_only_sweeps_serviced_channels);
+}
@@ -0,0 +1,122 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlMux.h>
+#include <CtrlMuxBus.h>
+#include <CtrlPot.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_mux_static_processes_objects()
+{
+    CtrlMuxT<16, 4> mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlBtn button(9, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[MUX_S0_PIN]);
+    TEST_ASSERT_EQUAL_INT(LOW, _mock_digital_pins()[MUX_S1_PIN]);
+    TEST_ASSERT_EQUAL_INT(LOW, _mock_digital_pins()[MUX_S2_PIN]);
+    TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[MUX_S3_PIN]);
+}
+
+static void test_mux_static_rejects_objects_beyond_capacity()
+{
+    CtrlMuxT<16, 2> mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    mux.reserve(8);
+    CtrlBtn btnD(3, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    TEST_ASSERT_TRUE(btnA.isMuxed());
+    TEST_ASSERT_TRUE(btnB.isMuxed());
+    TEST_ASSERT_FALSE(btnC.isMuxed());
+    TEST_ASSERT_FALSE(btnD.isMuxed());
+
+    // A removed object frees its slot.
+    btnA.setMultiplexer(nullptr);
+    TEST_ASSERT_TRUE(btnC.setMultiplexer(&mux));
+}
+
+static void test_mux_static_eight_channels_ignore_s3()
+{
+    CtrlMuxT<8, 2> mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlPot potentiometer(7, 100, TEST_SENSITIVITY, nullptr, &mux);
+    CtrlBtn outOfRange(12, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_S3_PIN] = LOW;
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    _mock_analog_pins()[MUX_SIG_PIN] = 1023;
+
+    converge(
+        [&]{ mux.process(); },
+        [&]{ return (int)potentiometer.getValue(); },
+        100
+    );
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_EQUAL_INT(100, potentiometer.getValue());
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[MUX_S2_PIN]);
+    TEST_ASSERT_EQUAL_INT(LOW, _mock_digital_pins()[MUX_S3_PIN]);
+}
+
+static uint8_t strayWrites = 0;
+static void countStrayWrite(const uint8_t pin, uint8_t)
+{
+    if (pin >= MOCK_PIN_COUNT) ++strayWrites;
+}
+
+static void test_mux_static_sixteen_channels_without_s3_select_eight()
+{
+    const _MockDigitalWriteHook previous = _mock_digital_write_hook();
+    _mock_digital_write_hook() = &countStrayWrite;
+    strayWrites = 0;
+    CtrlMuxT<16, 2> mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, UINT8_MAX);
+
+    CtrlBtn inRange(5, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn outOfRange(12, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    for (int i = 0; i < 3; ++i) mux.process();
+    _mock_digital_write_hook() = previous;
+
+    TEST_ASSERT_EQUAL_INT(0, strayWrites);
+    TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[MUX_S2_PIN]);
+}
+
+static void test_mux_static_on_bus()
+{
+    CtrlMuxBus bus(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlMuxT<16, 2> mux(MUX_SIG_PIN, &bus);
+
+    CtrlBtn button(5, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &mux);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    bus.process();
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    bus.process();
+    delay(TEST_DEBOUNCE + 1);
+    bus.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+void run_multiplexer_static_tests()
+{
+    RUN_TEST(test_mux_static_processes_objects);
+    RUN_TEST(test_mux_static_rejects_objects_beyond_capacity);
+    RUN_TEST(test_mux_static_eight_channels_ignore_s3);
+    RUN_TEST(test_mux_static_sixteen_channels_without_s3_select_eight);
+    RUN_TEST(test_mux_static_on_bus);
+}
@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlClock.h>
+#include <CtrlEnc.h>
+#include <CtrlGroup.h>
+#include <CtrlInterrupts.h>
+#include <CtrlMux.h>
+#include <CtrlPinIOMock.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_interrupt_button_not_read_while_clean()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    TEST_ASSERT_TRUE(button.attachPinInterrupts());
+
+    _mock_reset_pin_io();
+    for (int i = 0; i < 10; ++i) button.process();
+
+    TEST_ASSERT_EQUAL_INT(0, _mock_pin_read_count());
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+}
+
+static void test_interrupt_button_can_be_pressed()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); });
+    button.attachPinInterrupts();
+    button.process();
+
+    _mock_pin_change(BTN_PIN, LOW);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    // The debounce runs from the time of the edge.
+    delay(TEST_DEBOUNCE);
+    _mock_reset_pin_io();
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(0, _mock_pin_read_count());
+
+    _mock_pin_change(BTN_PIN, HIGH);
+    button.process();
+    delay(TEST_DEBOUNCE);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+}
+
+static void test_interrupt_button_bounce_restarts_debounce()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    button.attachPinInterrupts();
+    button.process();
+
+    _mock_pin_change(BTN_PIN, LOW);
+    button.process();
+    delay(TEST_DEBOUNCE - 5);
+    _mock_pin_change(BTN_PIN, HIGH);
+    _mock_pin_change(BTN_PIN, LOW);
+    button.process();
+    delay(5);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(0, tracker.pressCount);
+
+    delay(TEST_DEBOUNCE);
+    button.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_interrupt_encoder_keeps_steps_between_process_calls()
+{
+    CtrlEnc encoder(ENC_CLK_PIN, ENC_DT_PIN, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); });
+    TEST_ASSERT_TRUE(encoder.attachPinInterrupts());
+    encoder.process();
+
+    // Two full steps right, without a process() call in between.
+    for (int i = 0; i < 2; ++i) {
+        _mock_pin_change(ENC_CLK_PIN, HIGH);
+        _mock_pin_change(ENC_DT_PIN, HIGH);
+        _mock_pin_change(ENC_CLK_PIN, LOW);
+        _mock_pin_change(ENC_DT_PIN, LOW);
+    }
+    _mock_reset_pin_io();
+    encoder.process();
+
+    TEST_ASSERT_EQUAL_INT(2, tracker.turnRightCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.turnLeftCount);
+    TEST_ASSERT_EQUAL_INT(0, _mock_pin_read_count());
+}
+
+static void test_interrupt_group_processes_only_dirty_objects()
+{
+    CtrlGroup group;
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    CtrlEnc encoder(ENC_CLK_PIN, ENC_DT_PIN);
+    button.setGroup(&group);
+    encoder.setGroup(&group);
+    group.setOnPress([](Groupable&){ tracker.recordPress(); });
+    button.attachPinInterrupts();
+    encoder.attachPinInterrupts();
+    group.process();
+
+    TEST_ASSERT_FALSE(button.needsProcessing());
+    TEST_ASSERT_FALSE(encoder.needsProcessing());
+
+    _mock_pin_change(BTN_PIN, LOW);
+    TEST_ASSERT_TRUE(button.needsProcessing());
+    group.process();
+    // Still dirty while the debounce is pending.
+    TEST_ASSERT_TRUE(button.needsProcessing());
+    delay(TEST_DEBOUNCE);
+    group.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    TEST_ASSERT_FALSE(button.needsProcessing());
+}
+
+static void test_interrupt_slots_are_limited_and_released()
+{
+    const uint8_t free = CtrlInterrupts::getFreeSlots();
+    TEST_ASSERT_EQUAL_INT(CtrlInterrupts::SLOTS, free);
+    {
+        CtrlEnc encoder(ENC_CLK_PIN, ENC_DT_PIN);
+        encoder.attachPinInterrupts();
+        TEST_ASSERT_EQUAL_INT(free - 2, CtrlInterrupts::getFreeSlots());
+    }
+    TEST_ASSERT_EQUAL_INT(free, CtrlInterrupts::getFreeSlots());
+
+    CtrlBtn* buttons[CtrlInterrupts::SLOTS + 1];
+    for (uint8_t i = 0; i <= CtrlInterrupts::SLOTS; ++i) {
+        buttons[i] = new CtrlBtn(static_cast<uint8_t>(20 + i), TEST_DEBOUNCE);
+        TEST_ASSERT_EQUAL(i < CtrlInterrupts::SLOTS, buttons[i]->attachPinInterrupts());
+    }
+    for (auto* button : buttons) delete button;
+    TEST_ASSERT_EQUAL_INT(free, CtrlInterrupts::getFreeSlots());
+    TEST_ASSERT_NULL(_mock_interrupt_handlers()[20]);
+}
+
+class IdleEncoder : public CtrlEnc
+{
+    public:
+        using CtrlEnc::CtrlEnc;
+        using CtrlEnc::isScanIdle;
+};
+
+static void test_interrupt_encoder_marks_activity_at_edge_time()
+{
+    IdleEncoder encoder(ENC_CLK_PIN, ENC_DT_PIN);
+    TEST_ASSERT_TRUE(encoder.attachPinInterrupts());
+    encoder.process();
+    {
+        // The interrupt lands late in a long pass, whose latched time is stale.
+        CtrlClock::Pass pass;
+        delay(80);
+        _mock_pin_change(ENC_CLK_PIN, HIGH);
+    }
+    delay(30);
+    encoder.process();
+
+    TEST_ASSERT_FALSE(encoder.isScanIdle(millis(), 100));
+    delay(70);
+    TEST_ASSERT_TRUE(encoder.isScanIdle(millis(), 100));
+}
+
+static void test_interrupt_pin_attached_only_once()
+{
+    CtrlBtn first(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+    CtrlBtn second(BTN_PIN, TEST_DEBOUNCE);
+    TEST_ASSERT_TRUE(first.attachPinInterrupts());
+    const uint8_t free = CtrlInterrupts::getFreeSlots();
+
+    TEST_ASSERT_FALSE(second.attachPinInterrupts());
+    TEST_ASSERT_EQUAL_INT(free, CtrlInterrupts::getFreeSlots());
+
+    _mock_pin_change(BTN_PIN, LOW);
+    first.process();
+    delay(TEST_DEBOUNCE);
+    first.process();
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_interrupt_not_attached_to_muxed_objects()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn button(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    TEST_ASSERT_FALSE(button.attachPinInterrupts());
+}
+
+void run_pin_interrupt_tests()
+{
+    RUN_TEST(test_interrupt_button_not_read_while_clean);
+    RUN_TEST(test_interrupt_button_can_be_pressed);
+    RUN_TEST(test_interrupt_button_bounce_restarts_debounce);
+    RUN_TEST(test_interrupt_encoder_keeps_steps_between_process_calls);
+    RUN_TEST(test_interrupt_group_processes_only_dirty_objects);
+    RUN_TEST(test_interrupt_slots_are_limited_and_released);
+    RUN_TEST(test_interrupt_encoder_marks_activity_at_edge_time);
+    RUN_TEST(test_interrupt_pin_attached_only_once);
+    RUN_TEST(test_interrupt_not_attached_to_muxed_objects);
+}
@@ -0,0 +1,85 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlMux.h>
+#include <CtrlPinIO.h>
+#include <CtrlPinIOMock.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_select_lines_write_only_on_change()
+{
+    CtrlSelectLines lines(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    lines.begin();
+
+    lines.select(9);
+    TEST_ASSERT_EQUAL_INT(1, _mock_select_write_count());
+    TEST_ASSERT_EQUAL_INT(4, _mock_digital_write_count());
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S0_PIN]);
+    TEST_ASSERT_EQUAL_INT(0, _mock_digital_pins()[MUX_S1_PIN]);
+    TEST_ASSERT_EQUAL_INT(0, _mock_digital_pins()[MUX_S2_PIN]);
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S3_PIN]);
+
+    lines.select(9);
+    TEST_ASSERT_EQUAL_INT(1, _mock_select_write_count());
+
+    lines.select(8);
+    TEST_ASSERT_EQUAL_INT(2, _mock_select_write_count());
+    TEST_ASSERT_EQUAL_INT(5, _mock_digital_write_count());
+    TEST_ASSERT_EQUAL_INT(0, _mock_digital_pins()[MUX_S0_PIN]);
+}
+
+static void test_select_lines_invalidate_rewrites_all_lines()
+{
+    CtrlSelectLines lines(MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN);
+    lines.begin();
+
+    lines.select(3);
+    _mock_digital_pins()[MUX_S1_PIN] = LOW; // Driven by someone else.
+    lines.invalidate();
+    lines.select(3);
+
+    TEST_ASSERT_EQUAL_INT(2, _mock_select_write_count());
+    TEST_ASSERT_EQUAL_INT(1, _mock_digital_pins()[MUX_S1_PIN]);
+    TEST_ASSERT_EQUAL_INT(8, lines.getChannelCount());
+}
+
+static void test_mux_selects_channel_in_one_transaction_per_read()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+    CtrlBtn btnB(15, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &mux);
+
+    mux.process();
+
+    _mock_reset_pin_io();
+    mux.process();
+
+    // Channel 0 -> 15 toggles all 4 lines, yet each switch is a single select write.
+    TEST_ASSERT_EQUAL_INT(2, _mock_select_write_count());
+    TEST_ASSERT_EQUAL_INT(2, _mock_pin_read_count());
+}
+
+static void test_direct_pin_reads_go_through_backend()
+{
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE, []{ tracker.recordPress(); });
+
+    button.process();
+
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    button.process();
+    delay(TEST_DEBOUNCE + 1);
+    button.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+    // The initial state read, plus one read per process() call.
+    TEST_ASSERT_EQUAL_INT(4, _mock_pin_read_count());
+}
+
+void run_pin_io_tests()
+{
+    RUN_TEST(test_select_lines_write_only_on_change);
+    RUN_TEST(test_select_lines_invalidate_rewrites_all_lines);
+    RUN_TEST(test_mux_selects_channel_in_one_transaction_per_read);
+    RUN_TEST(test_direct_pin_reads_go_through_backend);
+}
@@ -0,0 +1,186 @@
+#include <Arduino.h>
+#include <CtrlBase.h>
+#include <CtrlEnc.h>
+#include <CtrlGroup.h>
+#include <CtrlMux.h>
+#include <CtrlPot.h>
+#include <unity.h>
+#include "test_globals.h"
+
+class PriorityObject : public CtrlBase, public Muxable, public Groupable
+{
+    public:
+        int processCount = 0;
+
+        explicit PriorityObject(const Priority priority, CtrlMux* mux = nullptr) : Muxable(mux)
+        {
+            this->setPriority(priority);
+        }
+
+        void process() override { ++this->processCount; }
+
+        [[nodiscard]] uint8_t getScanPriority() const override { return this->priority; }
+};
+
+class PlanCountingMux : public CtrlMux
+{
+    public:
+        int builds = 0;
+
+        using CtrlMux::CtrlMux;
+
+    protected:
+        void buildScanPlan() override
+        {
+            ++this->builds;
+            CtrlMux::buildScanPlan();
+        }
+};
+
+static void test_group_high_priority_every_slice()
+{
+    CtrlGroup group;
+    PriorityObject normals[4] = {
+        PriorityObject(CtrlBase::PRIORITY_NORMAL),
+        PriorityObject(CtrlBase::PRIORITY_NORMAL),
+        PriorityObject(CtrlBase::PRIORITY_NORMAL),
+        PriorityObject(CtrlBase::PRIORITY_NORMAL),
+    };
+    for (auto& object : normals) object.setGroup(&group);
+    PriorityObject high(CtrlBase::PRIORITY_HIGH);
+    high.setGroup(&group);
+
+    for (int i = 0; i < 4; ++i) group.process(2);
+
+    TEST_ASSERT_EQUAL_INT(4, high.processCount);
+    for (auto& object : normals) TEST_ASSERT_EQUAL_INT(1, object.processCount);
+}
+
+static void test_group_low_priority_less_often()
+{
+    CtrlGroup group;
+    PriorityObject normal(CtrlBase::PRIORITY_NORMAL);
+    PriorityObject low(CtrlBase::PRIORITY_LOW);
+    normal.setGroup(&group);
+    low.setGroup(&group);
+
+    for (int i = 0; i < 8; ++i) group.process(1);
+
+    // Low priority objects get a turn every LOW_PRIORITY_INTERVAL rounds.
+    TEST_ASSERT_EQUAL_INT(6, normal.processCount);
+    TEST_ASSERT_EQUAL_INT(2, low.processCount);
+}
+
+static void test_group_slice_stays_bounded()
+{
+    CtrlGroup group;
+    PriorityObject highs[3] = {
+        PriorityObject(CtrlBase::PRIORITY_HIGH),
+        PriorityObject(CtrlBase::PRIORITY_HIGH),
+        PriorityObject(CtrlBase::PRIORITY_HIGH),
+    };
+    PriorityObject normal(CtrlBase::PRIORITY_NORMAL);
+    normal.setGroup(&group);
+    for (auto& object : highs) object.setGroup(&group);
+
+    group.process(3);
+
+    // One slot is kept for the others, the high priority objects take turns.
+    int total = normal.processCount;
+    for (auto& object : highs) total += object.processCount;
+    TEST_ASSERT_EQUAL_INT(3, total);
+    TEST_ASSERT_EQUAL_INT(1, normal.processCount);
+
+    group.process(3);
+    for (auto& object : highs) TEST_ASSERT_TRUE(object.processCount >= 1);
+}
+
+static void test_group_full_pass_processes_all_priorities()
+{
+    CtrlGroup group;
+    PriorityObject high(CtrlBase::PRIORITY_HIGH);
+    PriorityObject normal(CtrlBase::PRIORITY_NORMAL);
+    PriorityObject low(CtrlBase::PRIORITY_LOW);
+    high.setGroup(&group);
+    normal.setGroup(&group);
+    low.setGroup(&group);
+
+    group.process();
+    group.process();
+
+    TEST_ASSERT_EQUAL_INT(2, high.processCount);
+    TEST_ASSERT_EQUAL_INT(2, normal.processCount);
+    TEST_ASSERT_EQUAL_INT(2, low.processCount);
+}
+
+static void test_priority_change_after_adding()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    PriorityObject a(CtrlBase::PRIORITY_NORMAL, &mux);
+    PriorityObject b(CtrlBase::PRIORITY_NORMAL, &mux);
+    PriorityObject c(CtrlBase::PRIORITY_NORMAL, &mux);
+
+    mux.process(1);
+    c.setPriority(CtrlBase::PRIORITY_HIGH);
+    for (int i = 0; i < 4; ++i) mux.process(2);
+
+    TEST_ASSERT_EQUAL_INT(CtrlBase::PRIORITY_HIGH, c.getPriority());
+    TEST_ASSERT_EQUAL_INT(4, c.processCount);
+    TEST_ASSERT_EQUAL_INT(5, a.processCount + b.processCount);
+}
+
+static void test_mux_high_priority_encoder_keeps_up()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+
+    CtrlEnc encoder(0, 1, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); }, &mux);
+    encoder.setPriority(CtrlBase::PRIORITY_HIGH);
+    CtrlPot potA(2, 100, TEST_SENSITIVITY, nullptr, &mux);
+    CtrlPot potB(3, 100, TEST_SENSITIVITY, nullptr, &mux);
+    CtrlPot potC(4, 100, TEST_SENSITIVITY, nullptr, &mux);
+
+    // Each quadrature state is only held for one slice.
+    const int states[][2] = {{HIGH, HIGH}, {LOW, HIGH}, {LOW, LOW}, {HIGH, LOW}, {HIGH, HIGH}};
+    for (const auto& state : states) {
+        int seq[] = {state[0], state[1]};
+        _mock_set_digital_sequence(MUX_SIG_PIN, seq, 2);
+        mux.process(2);
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.turnLeftCount + tracker.turnRightCount);
+}
+
+static void test_mux_removal_keeps_scan_plan()
+{
+    PlanCountingMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    PriorityObject highA(CtrlBase::PRIORITY_HIGH, &mux);
+    PriorityObject highB(CtrlBase::PRIORITY_HIGH, &mux);
+    PriorityObject normalA(CtrlBase::PRIORITY_NORMAL, &mux);
+    PriorityObject normalB(CtrlBase::PRIORITY_NORMAL, &mux);
+    PriorityObject normalC(CtrlBase::PRIORITY_NORMAL, &mux);
+
+    mux.process(2);
+    TEST_ASSERT_EQUAL_INT(1, normalA.processCount);
+    highA.setMultiplexer(nullptr);
+    const int highCount = highB.processCount;
+    for (int i = 0; i < 3; ++i) mux.process(2);
+
+    // Not rebuilt: the last normal object must not take the high slot of highA,
+    // and the others carry on in turn.
+    TEST_ASSERT_EQUAL_INT(1, mux.builds);
+    TEST_ASSERT_EQUAL_INT(highCount + 3, highB.processCount);
+    TEST_ASSERT_EQUAL_INT(2, normalA.processCount);
+    TEST_ASSERT_EQUAL_INT(1, normalB.processCount);
+    TEST_ASSERT_EQUAL_INT(1, normalC.processCount);
+}
+
+void run_scan_priority_tests()
+{
+    RUN_TEST(test_group_high_priority_every_slice);
+    RUN_TEST(test_group_low_priority_less_often);
+    RUN_TEST(test_group_slice_stays_bounded);
+    RUN_TEST(test_group_full_pass_processes_all_priorities);
+    RUN_TEST(test_priority_change_after_adding);
+    RUN_TEST(test_mux_high_priority_encoder_keeps_up);
+    RUN_TEST(test_mux_removal_keeps_scan_plan);
+}
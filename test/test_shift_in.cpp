@@ -0,0 +1,159 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlEnc.h>
+#include <CtrlGroup.h>
+#include <CtrlPinIOMock.h>
+#include <CtrlShiftIn.h>
+#include <Mock74HC165.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_shift_in_captures_chain_once_per_pass()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 2);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 2);
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &shiftIn);
+    CtrlBtn btnB(9, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &shiftIn);
+    CtrlEnc encoder(3, 4, nullptr, nullptr, &shiftIn);
+
+    shiftIn.process();
+
+    _mock_reset_pin_io();
+    _mock_pin_device() = &chain;
+    chain.loadCount = 0;
+    shiftIn.process();
+
+    // One latch, and one read per input of the chain, no matter how many objects read it.
+    TEST_ASSERT_EQUAL_INT(1, chain.loadCount);
+    TEST_ASSERT_EQUAL_INT(16, _mock_pin_read_count());
+}
+
+static void test_shift_in_captures_inputs_in_chain_order()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 3);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 3);
+
+    chain.inputs[0] = 0x81;
+    chain.inputs[1] = 0x3c;
+    chain.inputs[2] = 0x02;
+    shiftIn.capture();
+
+    TEST_ASSERT_EQUAL_UINT8(0x81, shiftIn.getInputs(0));
+    TEST_ASSERT_EQUAL_UINT8(0x3c, shiftIn.getInputs(1));
+    TEST_ASSERT_EQUAL_UINT8(0x02, shiftIn.getInputs(2));
+    TEST_ASSERT_EQUAL_UINT8(0, shiftIn.getInputs(3));
+    TEST_ASSERT_EQUAL_INT(24, shiftIn.getInputCount());
+}
+
+static void test_shift_in_button_can_be_pressed()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 2);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 2);
+
+    CtrlBtn button(13, TEST_DEBOUNCE, []{ tracker.recordPress(); }, []{ tracker.recordRelease(); }, nullptr, &shiftIn);
+    CtrlBtn other(12, TEST_DEBOUNCE, []{ tracker.recordPress(); }, nullptr, nullptr, &shiftIn);
+
+    chain.setAll(HIGH);
+    shiftIn.process();
+
+    chain.setInput(13, LOW);
+    shiftIn.process();
+    delay(TEST_DEBOUNCE + 1);
+    shiftIn.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+
+    chain.setInput(13, HIGH);
+    shiftIn.process();
+    delay(TEST_DEBOUNCE + 1);
+    shiftIn.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.releaseCount);
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_shift_in_encoder_can_turn_right()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 1);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN);
+
+    CtrlEnc encoder(6, 7, []{ tracker.recordTurnLeft(); }, []{ tracker.recordTurnRight(); }, &shiftIn);
+
+    for (int i = 0; i < 10; ++i) shiftIn.process();
+
+    chain.setInput(6, HIGH);
+    for (int i = 0; i < 10; ++i) shiftIn.process();
+
+    chain.setInput(7, HIGH);
+    for (int i = 0; i < 10; ++i) shiftIn.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.turnRightCount);
+    TEST_ASSERT_EQUAL_INT(0, tracker.turnLeftCount);
+}
+
+static void test_shift_in_inputs_out_of_range_read_low()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 1);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 1);
+
+    chain.setAll(HIGH);
+    TEST_ASSERT_TRUE(shiftIn.readBtnSig(7, INPUT_PULLUP));
+    TEST_ASSERT_FALSE(shiftIn.readBtnSig(8, INPUT_PULLUP));
+    TEST_ASSERT_EQUAL_INT(0, shiftIn.readPotSig(0, INPUT));
+}
+
+static void test_shift_in_objects_in_group_read_through_chain()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 1);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 1);
+    CtrlGroup group;
+
+    CtrlBtn button(2, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &shiftIn);
+    group.setOnPress([](Groupable&){ tracker.recordPress(); });
+    group.addObject(&button);
+
+    chain.setAll(HIGH);
+    group.process();
+    chain.setInput(2, LOW);
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    group.process();
+
+    TEST_ASSERT_EQUAL_INT(1, tracker.pressCount);
+}
+
+static void test_shift_in_captures_chain_once_per_group_pass()
+{
+    Mock74HC165 chain(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 2);
+    CtrlShiftIn shiftIn(SHIFT_DATA_PIN, SHIFT_CLOCK_PIN, SHIFT_LATCH_PIN, 2);
+    CtrlGroup group;
+
+    CtrlBtn btnA(0, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &shiftIn);
+    CtrlBtn btnB(9, TEST_DEBOUNCE, nullptr, nullptr, nullptr, &shiftIn);
+    CtrlEnc encoder(3, 4, nullptr, nullptr, &shiftIn);
+    group.addObject(&btnA);
+    group.addObject(&btnB);
+    group.addObject(&encoder);
+    group.process();
+
+    chain.loadCount = 0;
+    group.process();
+    TEST_ASSERT_EQUAL_INT(1, chain.loadCount);
+
+    // On its own, a button sees the chain as it is now.
+    btnA.process();
+    btnA.process();
+    TEST_ASSERT_EQUAL_INT(3, chain.loadCount);
+}
+
+void run_shift_in_tests()
+{
+    RUN_TEST(test_shift_in_captures_chain_once_per_pass);
+    RUN_TEST(test_shift_in_captures_inputs_in_chain_order);
+    RUN_TEST(test_shift_in_button_can_be_pressed);
+    RUN_TEST(test_shift_in_encoder_can_turn_right);
+    RUN_TEST(test_shift_in_inputs_out_of_range_read_low);
+    RUN_TEST(test_shift_in_objects_in_group_read_through_chain);
+    RUN_TEST(test_shift_in_captures_chain_once_per_group_pass);
+}
@@ -0,0 +1,174 @@
+#include <Arduino.h>
+#include <CtrlPot.h>
+#include <CtrlSpiAdc.h>
+#include <MockSpiAdc.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static void test_spi_adc_converts_used_channels_in_one_burst()
+{
+    MockSpiAdc chip(MockSpiAdc::MCP3008, ADC_CS_PIN);
+    SPI.attach(&chip);
+    CtrlSpiAdc adc(ADC_CS_PIN);
+
+    CtrlPot potA(1, 100, TEST_SENSITIVITY, nullptr, &adc);
+    CtrlPot potB(6, 100, TEST_SENSITIVITY, nullptr, &adc);
+
+    adc.process();
+
+    SPI.transactionCount = 0;
+    chip.conversionCount = 0;
+    adc.process();
+
+    // One transaction per pass, one conversion per used channel.
+    TEST_ASSERT_EQUAL_INT(1, SPI.transactionCount);
+    TEST_ASSERT_EQUAL_INT(2, chip.conversionCount);
+    TEST_ASSERT_EQUAL_INT(0, chip.conversions[0]);
+    TEST_ASSERT_EQUAL_INT(HIGH, _mock_digital_pins()[ADC_CS_PIN]);
+}
+
+static void test_spi_adc_mcp3008_pot_converges()
+{
+    MockSpiAdc chip(MockSpiAdc::MCP3008, ADC_CS_PIN);
+    SPI.attach(&chip);
+    CtrlSpiAdc adc(ADC_CS_PIN, CtrlSpiAdc::MCP3008);
+
+    CtrlPot potentiometer(7, 100, TEST_SENSITIVITY, nullptr, &adc);
+    chip.inputs[7] = 1023;
+
+    converge(
+        [&]{ adc.process(); },
+        [&]{ return (int)potentiometer.getValue(); },
+        100
+    );
+
+    TEST_ASSERT_EQUAL_INT(100, potentiometer.getValue());
+    TEST_ASSERT_EQUAL_INT(1023, adc.getValue(7));
+    TEST_ASSERT_EQUAL_INT(1350000, SPI.settings.clock);
+}
+
+static void test_spi_adc_mcp3208_reads_12_bits()
+{
+    MockSpiAdc chip(MockSpiAdc::MCP3208, ADC_CS_PIN);
+    SPI.attach(&chip);
+    CtrlSpiAdc adc(ADC_CS_PIN, CtrlSpiAdc::MCP3208);
+
+    CtrlPot potentiometer(5, 100, TEST_SENSITIVITY, nullptr, &adc);
+    potentiometer.setAnalogMax(adc.getAnalogMax());
+    chip.inputs[5] = 2048;
+    chip.inputs[4] = 4095;
+
+    converge(
+        [&]{ adc.process(); },
+        [&]{ return (int)potentiometer.getValue(); },
+        50
+    );
+
+    TEST_ASSERT_EQUAL_INT(4095, adc.getAnalogMax());
+    TEST_ASSERT_EQUAL_INT(2048, adc.getValue(5));
+    TEST_ASSERT_EQUAL_INT(0, adc.getValue(4));
+    TEST_ASSERT_EQUAL_INT(50, potentiometer.getValue());
+}
+
+static void test_spi_adc_ads7953_maps_results_to_channels()
+{
+    MockSpiAdc chip(MockSpiAdc::ADS7953, ADC_CS_PIN);
+    SPI.attach(&chip);
+    CtrlSpiAdc adc(ADC_CS_PIN, CtrlSpiAdc::ADS7953);
+
+    CtrlPot potA(2, 100, TEST_SENSITIVITY, nullptr, &adc);
+    CtrlPot potB(9, 100, TEST_SENSITIVITY, nullptr, &adc);
+    CtrlPot potC(15, 100, TEST_SENSITIVITY, nullptr, &adc);
+    chip.inputs[2] = 1000;
+    chip.inputs[9] = 2000;
+    chip.inputs[15] = 3000;
+
+    SPI.transactionCount = 0;
+    chip.conversionCount = 0;
+    adc.process();
+
+    // 3 channels, plus 2 frames for the pipeline, in a single transaction.
+    TEST_ASSERT_EQUAL_INT(1, SPI.transactionCount);
+    TEST_ASSERT_EQUAL_INT(5, chip.conversionCount);
+    TEST_ASSERT_EQUAL_INT(1000, adc.getValue(2));
+    TEST_ASSERT_EQUAL_INT(2000, adc.getValue(9));
+    TEST_ASSERT_EQUAL_INT(3000, adc.getValue(15));
+    TEST_ASSERT_EQUAL_INT(0, adc.getValue(0));
+}
+
+static void test_spi_adc_isr_conversions_feed_store_raw()
+{
+    MockSpiAdc chip(MockSpiAdc::MCP3008, ADC_CS_PIN);
+    SPI.attach(&chip);
+    CtrlSpiAdc adc(ADC_CS_PIN);
+    adc.setAutoConvert(false);
+
+    CtrlPot potentiometer(3, 100, TEST_SENSITIVITY, nullptr, &adc);
+    adc.process();
+
+    // Without conversions, process() does not touch the bus.
+    SPI.transactionCount = 0;
+    adc.process();
+    TEST_ASSERT_EQUAL_INT(0, SPI.transactionCount);
+
+    chip.inputs[3] = 1023;
+    converge(
+        [&]{ adc.convert(); adc.process(); }, // convert() as if from a timer ISR.
+        [&]{ return (int)potentiometer.getValue(); },
+        100
+    );
+
+    TEST_ASSERT_EQUAL_INT(100, potentiometer.getValue());
+}
+
+class StoredInput : public Muxable
+{
+    public:
+        uint8_t channel;
+        int storeCount = 0;
+
+        StoredInput(const uint8_t channel, CtrlSource* mux) : Muxable(mux), channel(channel) { }
+
+        void process() override { }
+
+    protected:
+        [[nodiscard]] uint8_t getMuxChannel() const override { return this->channel; }
+        [[nodiscard]] uint16_t getMuxChannelMask() const override { return 1u << this->channel; }
+        [[nodiscard]] bool isMuxAnalog() const override { return true; }
+        void storeMuxValue(uint16_t) override { ++this->storeCount; }
+};
+
+static void test_spi_adc_isr_feeds_objects_of_last_pass()
+{
+    MockSpiAdc chip(MockSpiAdc::MCP3008, ADC_CS_PIN);
+    SPI.attach(&chip);
+    CtrlSpiAdc adc(ADC_CS_PIN);
+    adc.setAutoConvert(false);
+    TEST_ASSERT_EQUAL_UINT8(255, SPI.usedInterrupt);
+
+    StoredInput inputA(1, &adc);
+    adc.process();
+    adc.convert();
+    TEST_ASSERT_EQUAL_INT(1, inputA.storeCount);
+
+    // Added after the pass: the ISR only picks it up after the next process().
+    StoredInput inputB(2, &adc);
+    adc.convert();
+    TEST_ASSERT_EQUAL_INT(2, inputA.storeCount);
+    TEST_ASSERT_EQUAL_INT(0, inputB.storeCount);
+
+    adc.process();
+    adc.convert();
+    TEST_ASSERT_EQUAL_INT(3, inputA.storeCount);
+    TEST_ASSERT_EQUAL_INT(1, inputB.storeCount);
+}
+
+void run_spi_adc_tests()
+{
+    RUN_TEST(test_spi_adc_converts_used_channels_in_one_burst);
+    RUN_TEST(test_spi_adc_mcp3008_pot_converges);
+    RUN_TEST(test_spi_adc_mcp3208_reads_12_bits);
+    RUN_TEST(test_spi_adc_ads7953_maps_results_to_channels);
+    RUN_TEST(test_spi_adc_isr_conversions_feed_store_raw);
+    RUN_TEST(test_spi_adc_isr_feeds_objects_of_last_pass);
+}
@@ -0,0 +1,116 @@
+#include <Arduino.h>
+#include <CtrlBase.h>
+#include <CtrlGroup.h>
+#include <CtrlMux.h>
+#include <Muxable.h>
+#include <unity.h>
+#include "test_globals.h"
+
+class CostObject : public CtrlBase, public Muxable, public Groupable
+{
+    public:
+        unsigned int cost;
+        int processCount = 0;
+
+        explicit CostObject(const unsigned int cost = 10, CtrlMux* mux = nullptr) : Muxable(mux), cost(cost) { }
+
+        void process() override
+        {
+            ++this->processCount;
+            delayMicroseconds(this->cost);
+        }
+
+        [[nodiscard]] uint8_t getScanPriority() const override { return this->priority; }
+};
+
+static void test_cost_estimate_is_moving_average()
+{
+    uint16_t cost = 0;
+    ctrlUpdateCost(cost, 40);
+    TEST_ASSERT_EQUAL_UINT16(40, cost);
+    ctrlUpdateCost(cost, 80);
+    TEST_ASSERT_EQUAL_UINT16(50, cost);
+    ctrlUpdateCost(cost, 100000);
+    TEST_ASSERT_EQUAL_UINT16(16422, cost);
+}
+
+static void test_group_process_for_stays_within_budget()
+{
+    CtrlGroup group;
+    CostObject objects[10];
+    for (auto& object : objects) object.setGroup(&group);
+
+    // The first pass learns the cost of every object.
+    group.processFor(1000);
+
+    size_t serviced = 0;
+    for (int i = 0; i < 5; ++i) {
+        const unsigned long start = micros();
+        const size_t processed = group.processFor(40);
+        // About 10 us per object, plus the overhead of reading the (mock) clock.
+        TEST_ASSERT_TRUE(processed >= 2 && processed <= 3);
+        TEST_ASSERT_TRUE(micros() - start <= 40 + 15);
+        serviced += processed;
+    }
+
+    // Round-robin: 10 objects in the first pass, then the sliced ones.
+    int total = 0;
+    for (auto& object : objects) total += object.processCount;
+    TEST_ASSERT_EQUAL_INT(10 + (int)serviced, total);
+    for (auto& object : objects) TEST_ASSERT_TRUE(object.processCount >= 2);
+}
+
+static void test_process_for_always_makes_progress()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CostObject slow(500, &mux);
+    CostObject other(500, &mux);
+
+    TEST_ASSERT_EQUAL_UINT32(1, mux.processFor(10));
+    TEST_ASSERT_EQUAL_UINT32(1, mux.processFor(10));
+
+    TEST_ASSERT_EQUAL_INT(1, slow.processCount);
+    TEST_ASSERT_EQUAL_INT(1, other.processCount);
+}
+
+static void test_process_for_services_high_priority_first()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CostObject normalA(20, &mux);
+    CostObject normalB(20, &mux);
+    CostObject high(20, &mux);
+    high.setPriority(CtrlBase::PRIORITY_HIGH);
+
+    for (int i = 0; i < 4; ++i) mux.processFor(1);
+
+    TEST_ASSERT_EQUAL_INT(4, high.processCount);
+    TEST_ASSERT_EQUAL_INT(0, normalA.processCount + normalB.processCount);
+}
+
+static void test_process_for_period_holds_loop_period()
+{
+    CtrlGroup group;
+    CostObject objects[40];
+    for (auto& object : objects) object.setGroup(&group);
+
+    unsigned long loopStart = micros();
+    unsigned long period = 0;
+    for (int i = 0; i < 50; ++i) {
+        delayMicroseconds(600); // The rest of the loop.
+        group.processForPeriod(1000);
+        const unsigned long now = micros();
+        period = now - loopStart;
+        loopStart = now;
+    }
+
+    TEST_ASSERT_TRUE(period >= 950 && period <= 1050);
+}
+
+void run_time_budget_tests()
+{
+    RUN_TEST(test_cost_estimate_is_moving_average);
+    RUN_TEST(test_group_process_for_stays_within_budget);
+    RUN_TEST(test_process_for_always_makes_progress);
+    RUN_TEST(test_process_for_services_high_priority_first);
+    RUN_TEST(test_process_for_period_holds_loop_period);
+}
@@ -0,0 +1,151 @@
+#include <Arduino.h>
+#include <CtrlBtn.h>
+#include <CtrlEnc.h>
+#include <CtrlGroup.h>
+#include <CtrlMux.h>
+#include <CtrlPinIOMock.h>
+#include <unity.h>
+#include "test_globals.h"
+
+static CtrlBtn* twoPhaseButtons[3] = {};
+static int pressedAtFirstCallback = -1;
+static unsigned long readsAtFirstCallback = 0;
+static CtrlMux* twoPhaseMux = nullptr;
+static bool reconfigured = true;
+
+static void recordFirstPress()
+{
+    if (pressedAtFirstCallback < 0) {
+        pressedAtFirstCallback = 0;
+        for (const CtrlBtn* button : twoPhaseButtons) {
+            if (button->isPressed()) ++pressedAtFirstCallback;
+        }
+        readsAtFirstCallback = _mock_pin_read_count();
+    }
+    tracker.recordPress();
+}
+
+static void pressAllChannels(CtrlMux& mux)
+{
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    _mock_reset_pin_io();
+    pressedAtFirstCallback = -1;
+    mux.process();
+}
+
+static void test_two_phase_scan_samples_all_before_callbacks()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn btnA(0, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    twoPhaseButtons[0] = &btnA;
+    twoPhaseButtons[1] = &btnB;
+    twoPhaseButtons[2] = &btnC;
+    TEST_ASSERT_TRUE(mux.setTwoPhaseScan(true));
+
+    pressAllChannels(mux);
+
+    // The first callback already sees every press, after every read of the pass.
+    TEST_ASSERT_EQUAL_INT(3, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(3, pressedAtFirstCallback);
+    TEST_ASSERT_EQUAL_UINT32(3, readsAtFirstCallback);
+}
+
+static void test_two_phase_scan_off_fires_inline()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn btnA(0, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    twoPhaseButtons[0] = &btnA;
+    twoPhaseButtons[1] = &btnB;
+    twoPhaseButtons[2] = &btnC;
+    mux.setTwoPhaseScan(true);
+    TEST_ASSERT_TRUE(mux.setTwoPhaseScan(false));
+
+    pressAllChannels(mux);
+
+    TEST_ASSERT_EQUAL_INT(3, tracker.pressCount);
+    TEST_ASSERT_EQUAL_INT(1, pressedAtFirstCallback);
+    TEST_ASSERT_EQUAL_UINT32(1, readsAtFirstCallback);
+}
+
+static void test_two_phase_scan_fires_in_order_beyond_capacity()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    CtrlBtn btnA(0, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    CtrlBtn btnB(1, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    CtrlBtn btnC(2, TEST_DEBOUNCE, recordFirstPress, nullptr, nullptr, &mux);
+    twoPhaseButtons[0] = &btnA;
+    twoPhaseButtons[1] = &btnB;
+    twoPhaseButtons[2] = &btnC;
+    TEST_ASSERT_TRUE(mux.setTwoPhaseScan(true, 1));
+
+    pressAllChannels(mux);
+
+    // Only one event fits: the others fire right away, none is lost.
+    TEST_ASSERT_EQUAL_INT(3, tracker.pressCount);
+}
+
+static void test_two_phase_scan_group_keeps_event_order()
+{
+    static char order[8];
+    static uint8_t length;
+    length = 0;
+
+    CtrlGroup group;
+    CtrlEnc encoder(ENC_CLK_PIN, ENC_DT_PIN, nullptr, nullptr);
+    CtrlBtn button(BTN_PIN, TEST_DEBOUNCE);
+    group.addObject(&encoder);
+    group.addObject(&button);
+    group.setOnTurnRight([](Groupable&){ if (length < 8) order[length++] = 'e'; });
+    group.setOnPress([](Groupable&){ if (length < 8) order[length++] = 'b'; });
+    TEST_ASSERT_TRUE(group.setTwoPhaseScan(true));
+
+    group.process();
+    _mock_digital_pins()[BTN_PIN] = LOW;
+    _mock_digital_pins()[ENC_CLK_PIN] = HIGH;
+    group.process();
+    delay(TEST_DEBOUNCE + 1);
+    _mock_digital_pins()[ENC_DT_PIN] = HIGH;
+    group.process();
+
+    // Both in one pass: fired in the order the objects were sampled (encoders first).
+    TEST_ASSERT_EQUAL_UINT8(2, length);
+    TEST_ASSERT_EQUAL_INT('e', order[0]);
+    TEST_ASSERT_EQUAL_INT('b', order[1]);
+}
+
+static void test_two_phase_scan_cannot_change_from_its_callbacks()
+{
+    CtrlMux mux(MUX_SIG_PIN, MUX_S0_PIN, MUX_S1_PIN, MUX_S2_PIN, MUX_S3_PIN);
+    twoPhaseMux = &mux;
+    reconfigured = true;
+    CtrlBtn button(0, TEST_DEBOUNCE, []{ reconfigured = twoPhaseMux->setTwoPhaseScan(false); }, nullptr, nullptr, &mux);
+    mux.setTwoPhaseScan(true);
+
+    _mock_digital_pins()[MUX_SIG_PIN] = HIGH;
+    mux.process();
+    _mock_digital_pins()[MUX_SIG_PIN] = LOW;
+    mux.process();
+    delay(TEST_DEBOUNCE + 1);
+    mux.process();
+
+    TEST_ASSERT_FALSE(reconfigured);
+    TEST_ASSERT_TRUE(mux.setTwoPhaseScan(false));
+    twoPhaseMux = nullptr;
+}
+
+void run_two_phase_scan_tests()
+{
+    RUN_TEST(test_two_phase_scan_samples_all_before_callbacks);
+    RUN_TEST(test_two_phase_scan_off_fires_inline);
+    RUN_TEST(test_two_phase_scan_fires_in_order_beyond_capacity);
+    RUN_TEST(test_two_phase_scan_group_keeps_event_order);
+    RUN_TEST(test_two_phase_scan_cannot_change_from_its_callbacks);
+}